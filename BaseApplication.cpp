@@ -17,6 +17,10 @@
 
 #include "ImguiManager.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #ifdef _DEBUG
     static const std::string mPluginsCfg = "plugins_d.cfg";
 #else
@@ -89,6 +93,8 @@ public:
         // === Create IMGUI ====
         m_imgui.Init(mSceneMgr, mKeyboard, mMouse); // OIS mouse + keyboard
 
+        mUiThread = std::thread(&DemoApp::UiThreadMain, this);
+
         mRoot->addFrameListener(this);
 
         mMouse->setEventCallback(this);
@@ -102,27 +108,90 @@ public:
 private:
     virtual bool frameRenderingQueued(const Ogre::FrameEvent& evt) override
     {
-        m_imgui.render();
+        m_imgui.render(); // Previous UI frame; the UI thread may still be building the current one
 
         return (!mWindow->isClosed() && (!mShutDown)); // False means "exit the application"
     }
 
     virtual bool frameStarted(const Ogre::FrameEvent& evt) override
     {
+        // Keeps the UI thread one frame behind; OIS input is queued and picked up by its next NewFrame()
+        this->WaitForUiFrame();
+
         // Need to capture/update each device
         mKeyboard->capture();
         mMouse->capture();
 
-        // ===== Start IMGUI frame =====
+        // ===== Start IMGUI frame on the UI thread; it overlaps the scene and UI submission of this frame =====
         Ogre::Viewport* vp = mWindow->getViewport(0);
-        m_imgui.NewFrame(evt.timeSinceLastFrame, (float)vp->getActualWidth(), (float)vp->getActualHeight());
+        const float displayWidth = (float)vp->getActualWidth();
+        const float displayHeight = (float)vp->getActualHeight();
+        mUiIdleTime += evt.timeSinceLastFrame;
+        if (!m_imgui.needsFrame(displayWidth, displayHeight))
+        {
+            return true; // Nothing changed since the last UI frame: render() draws that one again
+        }
 
-        // ===== Draw IMGUI demo window ====
-        ImGui::ShowTestWindow();
+        std::lock_guard<std::mutex> lock(mUiMutex);
+        mUiDeltaTime = mUiIdleTime; // Includes the frames skipped
+        mUiIdleTime = 0.f;
+        mUiDisplayWidth = displayWidth;
+        mUiDisplayHeight = displayHeight;
+        mUiFramePending = true;
+        mUiCondition.notify_all();
 
         return true;
     }
 
+    void UiThreadMain()
+    {
+        std::unique_lock<std::mutex> lock(mUiMutex);
+        for (;;)
+        {
+            mUiCondition.wait(lock, [this]{ return mUiFramePending || mUiThreadQuit; });
+            if (mUiThreadQuit)
+            {
+                return;
+            }
+
+            lock.unlock();
+            m_imgui.NewFrame(mUiDeltaTime, mUiDisplayWidth, mUiDisplayHeight);
+
+            // ===== Draw IMGUI demo window ====
+            ImGui::ShowTestWindow();
+            if (mShowFrameTimings)
+            {
+                m_imgui.showFrameTimings(&mShowFrameTimings);
+            }
+
+            m_imgui.EndFrame();
+            lock.lock();
+
+            mUiFramePending = false;
+            mUiCondition.notify_all();
+        }
+    }
+
+    void WaitForUiFrame()
+    {
+        std::unique_lock<std::mutex> lock(mUiMutex);
+        mUiCondition.wait(lock, [this]{ return !mUiFramePending; });
+    }
+
+    void StopUiThread()
+    {
+        if (!mUiThread.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mUiMutex);
+            mUiThreadQuit = true;
+            mUiCondition.notify_all();
+        }
+        mUiThread.join();
+    }
+
     bool keyPressed( const OIS::KeyEvent &arg ) override
     {
         if (arg.key == OIS::KC_ESCAPE) // All extras we need
@@ -178,6 +247,8 @@ private:
 
     void Shutdown()
     {
+        this->StopUiThread(); // It uses the input devices and IMGUI
+
         if(mInputManager)
         {
             mInputManager->destroyInputObject(mMouse);
@@ -188,6 +259,7 @@ private:
         }
         // Remove ourself as a Window listener
         Ogre::WindowEventUtilities::removeWindowEventListener(mWindow, this);
+        m_imgui.Shutdown(); // Release IMGUI's GPU buffers while OGRE still exists
         delete mRoot;
         mRoot = nullptr;
     }
@@ -204,6 +276,18 @@ private:
     OIS::InputManager*          mInputManager;
     OIS::Mouse*                 mMouse       ;
     OIS::Keyboard*              mKeyboard    ;
+
+    // UI thread
+    std::thread                 mUiThread;
+    std::mutex                  mUiMutex;
+    std::condition_variable     mUiCondition;
+    bool                        mUiFramePending = false; ///< Set by frameStarted(), cleared by the UI thread once EndFrame() is done
+    bool                        mUiThreadQuit = false;
+    bool                        mShowFrameTimings = true; ///< Only touched by the UI thread
+    float                       mUiDeltaTime = 0.f;
+    float                       mUiIdleTime = 0.f; ///< Time since the last UI frame was started
+    float                       mUiDisplayWidth = 0.f;
+    float                       mUiDisplayHeight = 0.f;
 };
 
 
@@ -0,0 +1,249 @@
+// Measures the per-frame CPU cost of ImguiBatchRenderer, the part of the OGRE back-end
+// which turns ImDrawData into buffer uploads and draws. The render system is replaced
+// by a device which writes to plain memory and counts what would have been sent to the GPU.
+
+#include "ImguiBenchmark.h"
+#include "ImguiBatchRenderer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+
+/// Stand-in for the OGRE hardware buffers and render system
+class CountingRenderDevice : public ImguiRenderDevice
+{
+public:
+    struct Counters
+    {
+        unsigned int bufferCreations;
+        unsigned int locks;
+        unsigned int discards;
+        size_t       bytesLocked;
+        unsigned int draws;
+        size_t       indicesDrawn;
+        unsigned int scissorChanges;
+        unsigned int textureChanges;
+        unsigned int stateApplications;
+    };
+
+    CountingRenderDevice() { this->resetCounters(); }
+
+    void resetCounters() { memset(&mCounters, 0, sizeof(mCounters)); }
+    const Counters& getCounters() const { return mCounters; }
+
+    virtual void createVertexBuffer(unsigned int numVertices) override
+    {
+        mVertices.resize(numVertices);
+        ++mCounters.bufferCreations;
+    }
+
+    virtual void createIndexBuffer(unsigned int numIndices) override
+    {
+        mIndices.resize(numIndices);
+        ++mCounters.bufferCreations;
+    }
+
+    virtual void lockBuffers(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount,
+                             bool discard, ImDrawVert** vtxDst, ImDrawIdx** idxDst) override
+    {
+        IM_ASSERT(vtxStart + vtxCount <= static_cast<unsigned int>(mVertices.Size));
+        IM_ASSERT(idxStart + idxCount <= static_cast<unsigned int>(mIndices.Size));
+        *vtxDst = mVertices.Data + vtxStart;
+        *idxDst = mIndices.Data + idxStart;
+        mCounters.locks += 2;
+        mCounters.discards += discard ? 1 : 0;
+        mCounters.bytesLocked += vtxCount * sizeof(ImDrawVert) + idxCount * sizeof(ImDrawIdx);
+    }
+
+    virtual void unlockBuffers() override {}
+
+    virtual void beginRender() override { ++mCounters.stateApplications; }
+
+    virtual void setScissor(int left, int top, int right, int bottom) override
+    {
+        (void)left; (void)top; (void)right; (void)bottom;
+        ++mCounters.scissorChanges;
+    }
+
+    virtual void setTexture(ImTextureID texId) override
+    {
+        (void)texId;
+        ++mCounters.textureChanges;
+    }
+
+    virtual void drawIndexed(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount) override
+    {
+        IM_ASSERT(vtxStart + vtxCount <= static_cast<unsigned int>(mVertices.Size));
+        IM_ASSERT(idxStart + idxCount <= static_cast<unsigned int>(mIndices.Size));
+        (void)vtxStart; (void)vtxCount; (void)idxStart;
+        ++mCounters.draws;
+        mCounters.indicesDrawn += idxCount;
+    }
+
+    virtual void endRender() override {}
+
+private:
+    Counters             mCounters;
+    ImVector<ImDrawVert> mVertices; ///< Backing memory of the "hardware" buffers
+    ImVector<ImDrawIdx>  mIndices;
+};
+
+// Synthetic UIs, recorded once and replayed for every render mode
+
+void BuildStaticFrame(int frame)
+{
+    (void)frame; // Identical geometry every frame, like a HUD nobody interacts with
+    ImGui::SetNextWindowPos(ImVec2(10, 10));
+    ImGui::Begin("Static");
+    ImGui::Text("Static UI");
+    for (int i = 0; i < 20; ++i)
+    {
+        ImGui::Button("Button");
+        ImGui::SameLine();
+        ImGui::Text("Label %d", i);
+    }
+    ImGui::End();
+}
+
+void BuildStaticWithOverlayFrame(int frame)
+{
+    // The static UI plus a small window changing every frame, like an FPS counter:
+    // only the overlay's draw list needs uploading
+    BuildStaticFrame(frame);
+    ImGui::SetNextWindowPos(ImVec2(900, 10));
+    ImGui::Begin("Overlay", NULL, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::Text("Frame %d", frame);
+    ImGui::End();
+}
+
+void BuildDemoFrame(int frame)
+{
+    (void)frame;
+    bool open = true;
+    ImGui::SetNextWindowPos(ImVec2(10, 10));
+    ImGui::SetNextWindowSize(ImVec2(600, 700));
+    ImGui::ShowTestWindow(&open);
+    ImGui::SetNextWindowPos(ImVec2(650, 10));
+    ImGui::ShowMetricsWindow(&open);
+}
+
+void BuildManyWindowsFrame(int frame)
+{
+    for (int w = 0; w < 40; ++w)
+    {
+        char title[32];
+        sprintf(title, "Window %d", w);
+        ImGui::SetNextWindowPos(ImVec2(static_cast<float>((w % 8) * 150), static_cast<float>((w / 8) * 140)));
+        ImGui::SetNextWindowSize(ImVec2(145, 135));
+        ImGui::Begin(title);
+        for (int i = 0; i < 10; ++i)
+        {
+            ImGui::Text("Value %d: %d", i, frame * 10 + i); // Changes every frame
+        }
+        ImGui::End();
+    }
+}
+
+struct Scenario
+{
+    const char* name;
+    void (*build)(int frame);
+};
+
+const Scenario Scenarios[] =
+{
+    { "static",              BuildStaticFrame },
+    { "static_with_overlay", BuildStaticWithOverlayFrame },
+    { "demo",                BuildDemoFrame },
+    { "many_windows",        BuildManyWindowsFrame },
+};
+
+const int RecordedFrameCount = 60;
+const int DisplayWidth = 1280;
+const int DisplayHeight = 800;
+
+void RecordScenario(const Scenario& scenario, ImguiBenchmark::FrameRecording& recording)
+{
+    recording.Clear();
+    for (int frame = 0; frame < RecordedFrameCount + 2; ++frame)
+    {
+        ImGui::NewFrame();
+        scenario.build(frame);
+        ImGui::Render();
+        if (frame >= 2) // Skip the frames where windows are still auto-fitting
+        {
+            recording.Capture(ImGui::GetDrawData());
+        }
+    }
+}
+
+const char* RenderModeName(ImguiBatchRenderer::RenderMode mode)
+{
+    return (mode == ImguiBatchRenderer::RM_MERGED_FRAME) ? "merged_frame" : "per_draw_list";
+}
+
+void ReplayScenario(const char* scenarioName, const ImguiBenchmark::FrameRecording& recording,
+                    ImguiBatchRenderer::RenderMode mode, int iterations)
+{
+    CountingRenderDevice device;
+    ImguiBatchRenderer renderer;
+    renderer.setDevice(&device);
+    renderer.setRenderMode(mode);
+
+    // Warm-up pass: buffers reach their working size, like after the first frames in the app
+    for (int i = 0; i < recording.GetFrameCount(); ++i)
+    {
+        renderer.render(recording.GetFrame(i), DisplayWidth, DisplayHeight);
+    }
+    device.resetCounters();
+
+    unsigned int skipped = 0;
+    const double start = ImguiBenchmark::GetTimeNs();
+    for (int it = 0; it < iterations; ++it)
+    {
+        for (int i = 0; i < recording.GetFrameCount(); ++i)
+        {
+            renderer.render(recording.GetFrame(i), DisplayWidth, DisplayHeight);
+            skipped += renderer.getRenderStats().uploadsSkipped;
+        }
+    }
+    const double elapsed = ImguiBenchmark::GetTimeNs() - start;
+
+    const double frames = static_cast<double>(iterations) * recording.GetFrameCount();
+    const CountingRenderDevice::Counters& c = device.getCounters();
+    char caseName[64];
+    sprintf(caseName, "%s/%s", scenarioName, RenderModeName(mode));
+    ImguiBenchmark::Report("backend", caseName, "ns_per_frame", elapsed / frames);
+    ImguiBenchmark::Report("backend", caseName, "buffer_creations", c.bufferCreations);
+    ImguiBenchmark::Report("backend", caseName, "locks_per_frame", c.locks / frames);
+    ImguiBenchmark::Report("backend", caseName, "discards_per_frame", c.discards / frames);
+    ImguiBenchmark::Report("backend", caseName, "bytes_per_frame", c.bytesLocked / frames);
+    ImguiBenchmark::Report("backend", caseName, "uploads_skipped_per_frame", skipped / frames);
+    ImguiBenchmark::Report("backend", caseName, "draws_per_frame", c.draws / frames);
+    ImguiBenchmark::Report("backend", caseName, "indices_per_frame", c.indicesDrawn / frames);
+    ImguiBenchmark::Report("backend", caseName, "scissor_changes_per_frame", c.scissorChanges / frames);
+    ImguiBenchmark::Report("backend", caseName, "texture_changes_per_frame", c.textureChanges / frames);
+    ImguiBenchmark::Report("backend", caseName, "state_applications_per_frame", c.stateApplications / frames);
+
+    renderer.setDevice(0);
+}
+
+} // anonymous namespace
+
+void ImguiBenchmark::RunBackendSuite(int iterations)
+{
+    InitImGui(static_cast<float>(DisplayWidth), static_cast<float>(DisplayHeight));
+
+    FrameRecording recording;
+    for (size_t s = 0; s < sizeof(Scenarios) / sizeof(Scenarios[0]); ++s)
+    {
+        RecordScenario(Scenarios[s], recording);
+        ReplayScenario(Scenarios[s].name, recording, ImguiBatchRenderer::RM_PER_DRAW_LIST, iterations);
+        ReplayScenario(Scenarios[s].name, recording, ImguiBatchRenderer::RM_MERGED_FRAME, iterations);
+    }
+    recording.Clear();
+
+    ShutdownImGui();
+}
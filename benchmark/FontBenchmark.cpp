@@ -0,0 +1,119 @@
+// Measures ImFontAtlas::Build() with a growing number of threads (ImFontAtlas::BuildThreadCount).
+// Only the build is timed; the TTF file is read once up front.
+// Reads fonts/Roboto-Medium.ttf, so run from the repository root.
+
+#include "ImguiBenchmark.h"
+
+#include <imgui_internal.h> // ImFileLoadToMemory
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+namespace
+{
+
+const char* const FontPath = "fonts/Roboto-Medium.ttf";
+
+struct FontSet
+{
+    const char* name;
+    void (*add)(ImFontAtlas* atlas, void* ttfData, int ttfSize);
+};
+
+void AddFont(ImFontAtlas* atlas, void* ttfData, int ttfSize, float sizePixels, int oversampleH, const ImWchar* ranges)
+{
+    ImFontConfig config;
+    config.FontDataOwnedByAtlas = false; // The atlas takes a copy, ttfData is reused by every build
+    config.OversampleH = oversampleH;
+    atlas->AddFontFromMemoryTTF(ttfData, ttfSize, sizePixels, &config, ranges);
+}
+
+/// What an application typically loads: a few sizes of the UI font plus the default font
+void AddUiFonts(ImFontAtlas* atlas, void* ttfData, int ttfSize)
+{
+    atlas->AddFontDefault();
+    AddFont(atlas, ttfData, ttfSize, 13.0f, 3, atlas->GetGlyphRangesCyrillic());
+    AddFont(atlas, ttfData, ttfSize, 16.0f, 3, atlas->GetGlyphRangesCyrillic());
+    AddFont(atlas, ttfData, ttfSize, 24.0f, 3, atlas->GetGlyphRangesCyrillic());
+    AddFont(atlas, ttfData, ttfSize, 32.0f, 3, atlas->GetGlyphRangesDefault());
+}
+
+/// One large font: its ranges are split between the threads
+void AddSingleLargeFont(ImFontAtlas* atlas, void* ttfData, int ttfSize)
+{
+    AddFont(atlas, ttfData, ttfSize, 48.0f, 3, atlas->GetGlyphRangesCyrillic());
+}
+
+const FontSet FontSets[] =
+{
+    { "ui_fonts",    AddUiFonts },
+    { "single_font", AddSingleLargeFont },
+};
+
+/// Average duration of a build, in nanoseconds
+double MeasureBuild(const FontSet& fontSet, void* ttfData, int ttfSize, int threadCount, int builds)
+{
+    double total = 0.0;
+    for (int i = 0; i < builds; ++i)
+    {
+        ImFontAtlas atlas;
+        atlas.BuildThreadCount = threadCount;
+        fontSet.add(&atlas, ttfData, ttfSize);
+
+        const double start = ImguiBenchmark::GetTimeNs();
+        atlas.Build();
+        total += ImguiBenchmark::GetTimeNs() - start;
+    }
+    return total / builds;
+}
+
+} // anonymous namespace
+
+void ImguiBenchmark::RunFontSuite(int iterations)
+{
+    int ttfSize = 0;
+    void* ttfData = ImFileLoadToMemory(FontPath, "rb", &ttfSize);
+    if (ttfData == NULL)
+    {
+        fprintf(stderr, "fonts: cannot open %s, run from the repository root\n", FontPath);
+        return;
+    }
+
+    // A build takes tens of milliseconds, an iteration count fit for per-frame measurements would take minutes
+    const int builds = (iterations / 20 > 3) ? iterations / 20 : 3;
+
+    // 1, 2, 4... up to the number of hardware threads, which is measured too when it isn't a power of two
+    const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    ImVector<int> threadCounts;
+    for (int n = 1; n <= hardwareThreads || n == 1; n *= 2)
+    {
+        threadCounts.push_back(n);
+    }
+    if (hardwareThreads > threadCounts.back())
+    {
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    for (size_t s = 0; s < sizeof(FontSets) / sizeof(FontSets[0]); ++s)
+    {
+        MeasureBuild(FontSets[s], ttfData, ttfSize, 1, 1); // Warm-up: page in the code and the allocator
+
+        double singleThreaded = 0.0;
+        for (int t = 0; t < threadCounts.Size; ++t)
+        {
+            const double ns = MeasureBuild(FontSets[s], ttfData, ttfSize, threadCounts[t], builds);
+            if (threadCounts[t] == 1)
+            {
+                singleThreaded = ns;
+            }
+
+            char caseName[64];
+            sprintf(caseName, "%s/threads_%d", FontSets[s].name, threadCounts[t]);
+            ImguiBenchmark::Report("fonts", caseName, "ns_per_build", ns);
+            ImguiBenchmark::Report("fonts", caseName, "speedup", singleThreaded / ns);
+        }
+    }
+
+    ImGui::MemFree(ttfData);
+}
@@ -0,0 +1,189 @@
+// Measures whole UI frames, NewFrame() to Render(), as an application runs them: the demo window and
+// synthetic stress scenes (many windows, deep trees, long lists). Nothing is rendered, the draw data is dropped.
+// Every scene runs in a fresh ImGuiContext whose allocator counts the calls, so allocations per frame are exact.
+
+#include "ImguiBenchmark.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace
+{
+
+const int WarmupFrames = 3;     ///< Not measured: windows are created and buffers grow during the first frames
+const int MinMeasuredFrames = 5;
+
+std::atomic<size_t> AllocationCount(0);
+
+void* CountingAlloc(size_t size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size);
+}
+
+void CountingFree(void* ptr)
+{
+    free(ptr);
+}
+
+// Widget state shared by the scenes, so the widgets have something to edit
+const int MaxWidgets = 200 * 500;
+float SliderValues[MaxWidgets];
+bool  CheckboxValues[MaxWidgets];
+
+struct FrameScene
+{
+    const char* name;
+    void (*build)(int a, int b);
+    int a, b;    ///< Scene parameters
+    int weight;  ///< Relative cost of a frame: the scene runs iterations / weight frames
+};
+
+void TestWindowScene(int, int)
+{
+    ImGui::ShowTestWindow();
+}
+
+/// `windowCount` windows, cascaded over the display, with `widgetCount` mixed widgets each; most are clipped, as in real tool UIs
+void WindowsScene(int windowCount, int widgetCount)
+{
+    for (int w = 0; w < windowCount; ++w)
+    {
+        char title[32];
+        sprintf(title, "Window %d", w);
+        ImGui::SetNextWindowPos(ImVec2(static_cast<float>(20 + (w % 40) * 24), static_cast<float>(20 + (w % 20) * 24)), ImGuiSetCond_FirstUseEver);
+        ImGui::SetNextWindowSize(ImVec2(320, 360), ImGuiSetCond_FirstUseEver);
+        ImGui::Begin(title);
+        for (int i = 0; i < widgetCount; ++i)
+        {
+            const int state = w * widgetCount + i;
+            ImGui::PushID(i);
+            switch (i % 4)
+            {
+            case 0: ImGui::Text("Item %d: %.3f", i, SliderValues[state]); break;
+            case 1: ImGui::Button("Button"); break;
+            case 2: ImGui::Checkbox("Enabled", &CheckboxValues[state]); break;
+            case 3: ImGui::SliderFloat("Value", &SliderValues[state], 0.0f, 1.0f); break;
+            }
+            ImGui::PopID();
+        }
+        ImGui::End();
+    }
+}
+
+void TreeLevel(int depth, int maxDepth, int leafCount)
+{
+    if (depth == maxDepth)
+    {
+        return;
+    }
+    ImGui::SetNextTreeNodeOpen(true, ImGuiSetCond_Always);
+    if (ImGui::TreeNode("Node"))
+    {
+        for (int i = 0; i < leafCount; ++i)
+        {
+            ImGui::BulletText("Leaf %d.%d", depth, i);
+        }
+        TreeLevel(depth + 1, maxDepth, leafCount);
+        ImGui::TreePop();
+    }
+}
+
+/// A single branch `depth` nodes deep, every node open with `leafCount` leaves
+void DeepTreeScene(int depth, int leafCount)
+{
+    ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiSetCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(800, 800), ImGuiSetCond_FirstUseEver);
+    ImGui::Begin("Tree");
+    TreeLevel(0, depth, leafCount);
+    ImGui::End();
+}
+
+/// `itemCount` lines of text in a scrolling window; submitted through ImGuiListClipper when `clipped` is non-zero
+void LongListScene(int itemCount, int clipped)
+{
+    ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiSetCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(400, 600), ImGuiSetCond_FirstUseEver);
+    ImGui::Begin("List");
+    if (clipped)
+    {
+        ImGuiListClipper clipper(itemCount);
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                ImGui::Text("Line %05d: %.3f", i, SliderValues[i]);
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < itemCount; ++i)
+        {
+            ImGui::Text("Line %05d: %.3f", i, SliderValues[i]);
+        }
+    }
+    ImGui::End();
+}
+
+const FrameScene FrameScenes[] =
+{
+    { "test_window",              TestWindowScene, 0,     0, 1 },
+    { "windows_20x50",            WindowsScene,    20,   50, 1 },
+    { "windows_200x500",          WindowsScene,    200, 500, 20 },
+    { "deep_tree_64",             DeepTreeScene,   64,    4, 1 },
+    { "long_list_10000",          LongListScene,   10000, 0, 4 },
+    { "long_list_10000_clipped",  LongListScene,   10000, 1, 1 },
+};
+
+void RunScene(const FrameScene& scene, int iterations)
+{
+    ImGuiContext* previousContext = ImGui::GetCurrentContext();
+    ImGuiContext* context = ImGui::CreateContext(CountingAlloc, CountingFree);
+    ImGui::SetCurrentContext(context);
+    ImguiBenchmark::InitImGui(1920.0f, 1080.0f);
+
+    const int measuredFrames = (iterations / scene.weight > MinMeasuredFrames) ? iterations / scene.weight : MinMeasuredFrames;
+    double total = 0.0;
+    size_t allocations = 0;
+    double vertices = 0.0;
+    for (int frame = 0; frame < WarmupFrames + measuredFrames; ++frame)
+    {
+        const size_t allocationsBefore = AllocationCount.load(std::memory_order_relaxed);
+        const double start = ImguiBenchmark::GetTimeNs();
+        ImGui::NewFrame();
+        scene.build(scene.a, scene.b);
+        ImGui::Render();
+        if (frame >= WarmupFrames)
+        {
+            total += ImguiBenchmark::GetTimeNs() - start;
+            allocations += AllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            vertices += ImGui::GetIO().MetricsRenderVertices;
+        }
+    }
+
+    ImguiBenchmark::ShutdownImGui();
+    ImGui::DestroyContext(context);
+    ImGui::SetCurrentContext(previousContext);
+
+    ImguiBenchmark::Report("frames", scene.name, "ns_per_frame", total / measuredFrames);
+    ImguiBenchmark::Report("frames", scene.name, "allocs_per_frame", static_cast<double>(allocations) / measuredFrames);
+    ImguiBenchmark::Report("frames", scene.name, "vertices_per_frame", vertices / measuredFrames);
+}
+
+} // anonymous namespace
+
+void ImguiBenchmark::RunFrameSuite(int iterations)
+{
+    for (int i = 0; i < MaxWidgets; ++i)
+    {
+        SliderValues[i] = static_cast<float>(i % 100) / 100.0f;
+        CheckboxValues[i] = (i % 3) == 0;
+    }
+
+    for (size_t s = 0; s < sizeof(FrameScenes) / sizeof(FrameScenes[0]); ++s)
+    {
+        RunScene(FrameScenes[s], iterations);
+    }
+}
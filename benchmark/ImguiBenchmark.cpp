@@ -0,0 +1,153 @@
+// Entry point of the headless benchmarks, see ImguiBenchmark.h
+//
+// Usage: IMGUI_benchmark [--iterations N] [suite ...]
+//        Runs all suites when none is given.
+//
+// Builds without OGRE; on Linux, from the repository root:
+//     g++ -O2 -std=c++11 -pthread -Ilib/DearIMGUI -Ilib/DearIMGUI_OGRE -Ibenchmark -o imgui_benchmark
+//         benchmark/*.cpp lib/DearIMGUI/imgui*.cpp lib/DearIMGUI_OGRE/ImguiBatchRenderer.cpp
+
+#include "ImguiBenchmark.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace ImguiBenchmark
+{
+
+double GetTimeNs()
+{
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Report(const char* suite, const char* caseName, const char* metric, double value)
+{
+    printf("{\"suite\":\"%s\",\"case\":\"%s\",\"metric\":\"%s\",\"value\":%.3f}\n", suite, caseName, metric, value);
+    fflush(stdout);
+}
+
+void InitImGui(float displayWidth, float displayHeight)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(displayWidth, displayHeight);
+    io.DeltaTime = 1.0f / 60.0f;
+    io.IniFilename = NULL; // Benchmarks must start from the same state every run
+
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    io.Fonts->TexID = reinterpret_cast<ImTextureID>(1); // Any non-NULL ID; nothing is uploaded
+}
+
+void ShutdownImGui()
+{
+    ImGui::Shutdown();
+}
+
+FrameRecording::Frame::~Frame()
+{
+    for (int i = 0; i < Lists.Size; ++i)
+    {
+        delete Lists[i];
+    }
+}
+
+FrameRecording::~FrameRecording()
+{
+    this->Clear();
+}
+
+void FrameRecording::Capture(const ImDrawData* drawData)
+{
+    Frame* frame = new Frame();
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+    {
+        // ImVector has no deep copy
+        const ImDrawList* src = drawData->CmdLists[i];
+        ImDrawList* dst = new ImDrawList();
+        dst->CmdBuffer.resize(src->CmdBuffer.Size);
+        dst->IdxBuffer.resize(src->IdxBuffer.Size);
+        dst->VtxBuffer.resize(src->VtxBuffer.Size);
+        memcpy(dst->CmdBuffer.Data, src->CmdBuffer.Data, src->CmdBuffer.Size * sizeof(ImDrawCmd));
+        memcpy(dst->IdxBuffer.Data, src->IdxBuffer.Data, src->IdxBuffer.Size * sizeof(ImDrawIdx));
+        memcpy(dst->VtxBuffer.Data, src->VtxBuffer.Data, src->VtxBuffer.Size * sizeof(ImDrawVert));
+        frame->Lists.push_back(dst);
+    }
+
+    frame->DrawData.Valid = true;
+    frame->DrawData.CmdLists = frame->Lists.Data;
+    frame->DrawData.CmdListsCount = frame->Lists.Size;
+    frame->DrawData.TotalVtxCount = drawData->TotalVtxCount;
+    frame->DrawData.TotalIdxCount = drawData->TotalIdxCount;
+    mFrames.push_back(frame);
+}
+
+void FrameRecording::Clear()
+{
+    for (int i = 0; i < mFrames.Size; ++i)
+    {
+        delete mFrames[i];
+    }
+    mFrames.resize(0);
+}
+
+} // namespace ImguiBenchmark
+
+struct BenchmarkSuite
+{
+    const char* name;
+    void (*run)(int iterations);
+};
+
+static const BenchmarkSuite Suites[] =
+{
+    { "backend", ImguiBenchmark::RunBackendSuite },
+    { "fonts",   ImguiBenchmark::RunFontSuite },
+    { "primitives", ImguiBenchmark::RunPrimitivesSuite },
+    { "frames",     ImguiBenchmark::RunFrameSuite },
+};
+static const int SuiteCount = sizeof(Suites) / sizeof(Suites[0]);
+
+int main(int argc, char** argv)
+{
+    int iterations = 200;
+    bool runAll = true;
+    bool selected[SuiteCount] = {};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = atoi(argv[++i]);
+            continue;
+        }
+
+        bool found = false;
+        for (int s = 0; s < SuiteCount; ++s)
+        {
+            if (strcmp(argv[i], Suites[s].name) == 0)
+            {
+                selected[s] = true;
+                runAll = false;
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            fprintf(stderr, "Unknown benchmark suite '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    for (int s = 0; s < SuiteCount; ++s)
+    {
+        if (runAll || selected[s])
+        {
+            Suites[s].run(iterations);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <imgui.h>
+
+/// Headless benchmarks: neither a GPU nor OGRE is needed, so they run on any build box.
+/// Results are printed as one JSON object per line, {"suite":..,"case":..,"metric":..,"value":..},
+/// which keeps runs easy to diff and to feed into regression tracking.
+namespace ImguiBenchmark
+{
+    /// Monotonic time in nanoseconds
+    double GetTimeNs();
+
+    void Report(const char* suite, const char* caseName, const char* metric, double value);
+
+    /// Sets up ImGui for headless frames: display size, built font atlas, no imgui.ini
+    void InitImGui(float displayWidth, float displayHeight);
+    void ShutdownImGui();
+
+    /// Deep copy of the draw data of a number of frames.
+    /// ImGui only keeps its ImDrawData until the next NewFrame(), recordings can be replayed at will.
+    class FrameRecording
+    {
+    public:
+        ~FrameRecording();
+
+        /// Appends a copy of the given frame
+        void Capture(const ImDrawData* drawData);
+        void Clear();
+
+        int GetFrameCount() const { return mFrames.Size; }
+        /// Valid until the recording is modified
+        const ImDrawData* GetFrame(int index) const { return &mFrames[index]->DrawData; }
+
+    private:
+        struct Frame
+        {
+            ~Frame();
+
+            ImDrawData               DrawData; ///< CmdLists points into Lists.Data
+            ImVector<ImDrawList*>    Lists;    ///< Owned
+        };
+
+        ImVector<Frame*> mFrames; ///< Owned
+    };
+
+    /// Benchmark suites, selected by name on the command line
+    void RunBackendSuite(int iterations);
+    void RunFontSuite(int iterations);
+    void RunPrimitivesSuite(int iterations);
+    void RunFrameSuite(int iterations);
+}
@@ -0,0 +1,253 @@
+// Measures the hot paths below the widgets: ImDrawList primitives, text layout and rendering,
+// ID hashing and ImGuiStorage. Every case is timed over a batch of calls, reported per call.
+// Storage cases are named after the storage mode, so runs of a regular build and of a build with
+// -DIMGUI_USE_HASHED_STORAGE can be compared side by side.
+
+#include "ImguiBenchmark.h"
+
+#include <imgui_internal.h> // ImHash
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+
+const int CallsPerBatch = 100; ///< Calls timed together, into a draw list cleared between batches
+const int PathPointCount = 64;
+const int ConvexPointCount = 32;
+
+ImVec2 PathPoints[PathPointCount];       ///< Zig-zag around a circle, so every joint is mitered
+ImVec2 ConvexPoints[ConvexPointCount];   ///< Circle
+
+const char ShortText[] = "Frame time 16.6 ms";
+const char ParagraphText[] =
+    "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs. "
+    "How vexingly quick daft zebras jump! Sphinx of black quartz, judge my vow. "
+    "The five boxing wizards jump quickly. Jackdaws love my big sphinx of quartz. "
+    "Waltz, bad nymph, for quick jigs vex. Glib jocks quiz nymph to vex dwarf.";
+
+/// Results of computations which would otherwise be optimized away
+volatile float  FloatSink;
+volatile ImU32  HashSink;
+volatile int    IntSink;
+
+#ifdef IMGUI_USE_HASHED_STORAGE
+const char* const StorageMode = "hashed";
+#else
+const char* const StorageMode = "sorted";
+#endif
+
+void InitShapes()
+{
+    for (int i = 0; i < PathPointCount; ++i)
+    {
+        const float a = 2.0f * IM_PI * i / PathPointCount;
+        const float r = (i & 1) ? 90.0f : 110.0f;
+        PathPoints[i] = ImVec2(200.0f + cosf(a) * r, 200.0f + sinf(a) * r);
+    }
+    for (int i = 0; i < ConvexPointCount; ++i)
+    {
+        const float a = 2.0f * IM_PI * i / ConvexPointCount;
+        ConvexPoints[i] = ImVec2(200.0f + cosf(a) * 100.0f, 200.0f + sinf(a) * 100.0f);
+    }
+}
+
+// Draw list cases
+
+void PolylineThin(ImDrawList* dl)         { dl->AddPolyline(PathPoints, PathPointCount, IM_COL32_WHITE, true, 1.0f, false); }
+void PolylineThinAA(ImDrawList* dl)       { dl->AddPolyline(PathPoints, PathPointCount, IM_COL32_WHITE, true, 1.0f, true); }
+void PolylineThick(ImDrawList* dl)        { dl->AddPolyline(PathPoints, PathPointCount, IM_COL32_WHITE, true, 2.5f, false); }
+void PolylineThickAA(ImDrawList* dl)      { dl->AddPolyline(PathPoints, PathPointCount, IM_COL32_WHITE, true, 2.5f, true); }
+void PolylineWideAA(ImDrawList* dl)       { dl->AddPolyline(PathPoints, PathPointCount, IM_COL32_WHITE, true, 6.0f, true); }
+void ConvexFilled(ImDrawList* dl)         { dl->AddConvexPolyFilled(ConvexPoints, ConvexPointCount, IM_COL32_WHITE, false); }
+void ConvexFilledAA(ImDrawList* dl)       { dl->AddConvexPolyFilled(ConvexPoints, ConvexPointCount, IM_COL32_WHITE, true); }
+void RectFilled(ImDrawList* dl)           { dl->AddRectFilled(ImVec2(10, 10), ImVec2(210, 60), IM_COL32_WHITE); }
+void RectFilledRounded4(ImDrawList* dl)   { dl->AddRectFilled(ImVec2(10, 10), ImVec2(210, 60), IM_COL32_WHITE, 4.0f); }
+void RectFilledRounded12(ImDrawList* dl)  { dl->AddRectFilled(ImVec2(10, 10), ImVec2(210, 60), IM_COL32_WHITE, 12.0f); }
+void TextShort(ImDrawList* dl)            { dl->AddText(ImVec2(10, 10), IM_COL32_WHITE, ShortText); }
+void TextParagraph(ImDrawList* dl)        { dl->AddText(ImVec2(10, 10), IM_COL32_WHITE, ParagraphText); }
+void TextParagraphWrapped(ImDrawList* dl) { dl->AddText(ImGui::GetFont(), ImGui::GetFontSize(), ImVec2(10, 10), IM_COL32_WHITE, ParagraphText, NULL, 300.0f); }
+
+struct DrawListCase
+{
+    const char* name;
+    void (*draw)(ImDrawList* dl);
+};
+
+const DrawListCase DrawListCases[] =
+{
+    { "add_polyline/thin",                PolylineThin },
+    { "add_polyline/thin_aa",             PolylineThinAA },
+    { "add_polyline/thick_2.5",           PolylineThick },
+    { "add_polyline/thick_2.5_aa",        PolylineThickAA },
+    { "add_polyline/thick_6_aa",          PolylineWideAA },
+    { "add_convex_poly_filled/32",        ConvexFilled },
+    { "add_convex_poly_filled/32_aa",     ConvexFilledAA },
+    { "add_rect_filled/square",           RectFilled },
+    { "add_rect_filled/rounding_4",       RectFilledRounded4 },
+    { "add_rect_filled/rounding_12",      RectFilledRounded12 },
+    { "add_text/short",                   TextShort },
+    { "add_text/paragraph",               TextParagraph },
+    { "add_text/paragraph_wrapped",       TextParagraphWrapped },
+};
+
+void RunDrawListCase(const DrawListCase& drawCase, int iterations)
+{
+    // A draw list of our own, set up like a window's: full screen clip rect, font atlas bound
+    ImDrawList dl;
+    size_t vertices = 0;
+    double total = 0.0;
+    for (int it = 0; it < iterations + 1; ++it)
+    {
+        dl.Clear();
+        dl.PushClipRectFullScreen();
+        dl.PushTextureID(ImGui::GetIO().Fonts->TexID);
+
+        const double start = ImguiBenchmark::GetTimeNs();
+        for (int i = 0; i < CallsPerBatch; ++i)
+        {
+            drawCase.draw(&dl);
+        }
+        if (it > 0) // The first batch grows the buffers
+        {
+            total += ImguiBenchmark::GetTimeNs() - start;
+            vertices += dl.VtxBuffer.Size;
+        }
+    }
+    dl.ClearFreeMemory();
+
+    const double calls = static_cast<double>(iterations) * CallsPerBatch;
+    ImguiBenchmark::Report("primitives", drawCase.name, "ns_per_call", total / calls);
+    ImguiBenchmark::Report("primitives", drawCase.name, "vertices_per_call", vertices / calls);
+}
+
+void RunCalcTextSize(const char* caseName, const char* text, float wrapWidth, int iterations)
+{
+    const ImFont* font = ImGui::GetFont();
+    const float size = ImGui::GetFontSize();
+    float sum = 0.0f;
+    const double start = ImguiBenchmark::GetTimeNs();
+    for (int it = 0; it < iterations; ++it)
+    {
+        for (int i = 0; i < CallsPerBatch; ++i)
+        {
+            sum += font->CalcTextSizeA(size, FLT_MAX, wrapWidth, text).y;
+        }
+    }
+    const double elapsed = ImguiBenchmark::GetTimeNs() - start;
+    FloatSink = sum;
+    ImguiBenchmark::Report("primitives", caseName, "ns_per_call", elapsed / (static_cast<double>(iterations) * CallsPerBatch));
+}
+
+void RunHash(const char* caseName, const char* format, int iterations)
+{
+    // Labels are formatted up front, only hashing is timed
+    const int labelCount = 256;
+    static char labels[labelCount][64];
+    for (int i = 0; i < labelCount; ++i)
+    {
+        sprintf(labels[i], format, i);
+    }
+
+    ImU32 seed = 0;
+    const double start = ImguiBenchmark::GetTimeNs();
+    for (int it = 0; it < iterations; ++it)
+    {
+        for (int i = 0; i < labelCount; ++i)
+        {
+            seed = ImHash(labels[i], 0, seed); // Zero terminated, like the labels passed to widgets
+        }
+    }
+    const double elapsed = ImguiBenchmark::GetTimeNs() - start;
+    HashSink = seed;
+    ImguiBenchmark::Report("primitives", caseName, "ns_per_call", elapsed / (static_cast<double>(iterations) * labelCount));
+}
+
+void RunStorage(int size, int iterations)
+{
+    // Keys are IDs, i.e. hashes: spread over the whole range and inserted in no particular order.
+    // Missing keys are looked up as often as stored ones, e.g. the state of tree nodes never opened.
+    ImVector<ImGuiID> keys;
+    ImVector<ImGuiID> missingKeys;
+    keys.resize(size);
+    missingKeys.resize(size);
+    for (int i = 0; i < size; ++i)
+    {
+        keys[i] = ImHash(&i, sizeof(i), 0);
+        missingKeys[i] = ImHash(&i, sizeof(i), 1);
+    }
+
+    const int rounds = (iterations * 64 / size > 1) ? iterations * 64 / size : 1; // Similar work for every size
+    double setTotal = 0.0;
+    double getTotal = 0.0;
+    double getMissingTotal = 0.0;
+    unsigned int sum = 0; // Wraps around
+    for (int r = 0; r < rounds; ++r)
+    {
+        ImGuiStorage storage;
+        double start = ImguiBenchmark::GetTimeNs();
+        for (int i = 0; i < size; ++i)
+        {
+            storage.SetInt(keys[i], i);
+        }
+        setTotal += ImguiBenchmark::GetTimeNs() - start;
+
+        start = ImguiBenchmark::GetTimeNs();
+        for (int i = 0; i < size; ++i)
+        {
+            sum += storage.GetInt(keys[i]);
+        }
+        getTotal += ImguiBenchmark::GetTimeNs() - start;
+
+        start = ImguiBenchmark::GetTimeNs();
+        for (int i = 0; i < size; ++i)
+        {
+            sum += storage.GetInt(missingKeys[i], 1);
+        }
+        getMissingTotal += ImguiBenchmark::GetTimeNs() - start;
+    }
+    IntSink = static_cast<int>(sum);
+
+    char caseName[64];
+    const double calls = static_cast<double>(rounds) * size;
+    sprintf(caseName, "storage_set/%s/%d", StorageMode, size);
+    ImguiBenchmark::Report("primitives", caseName, "ns_per_call", setTotal / calls);
+    sprintf(caseName, "storage_get/%s/%d", StorageMode, size);
+    ImguiBenchmark::Report("primitives", caseName, "ns_per_call", getTotal / calls);
+    sprintf(caseName, "storage_get_missing/%s/%d", StorageMode, size);
+    ImguiBenchmark::Report("primitives", caseName, "ns_per_call", getMissingTotal / calls);
+}
+
+} // anonymous namespace
+
+void ImguiBenchmark::RunPrimitivesSuite(int iterations)
+{
+    InitImGui(1280.0f, 800.0f);
+    InitShapes();
+
+    // Draw lists take the white pixel and the font from the current frame
+    ImGui::NewFrame();
+
+    for (size_t c = 0; c < sizeof(DrawListCases) / sizeof(DrawListCases[0]); ++c)
+    {
+        RunDrawListCase(DrawListCases[c], iterations);
+    }
+
+    RunCalcTextSize("calc_text_size/short", ShortText, 0.0f, iterations);
+    RunCalcTextSize("calc_text_size/paragraph", ParagraphText, 0.0f, iterations);
+    RunCalcTextSize("calc_text_size/paragraph_wrapped", ParagraphText, 300.0f, iterations);
+
+    RunHash("im_hash/short_label", "Button %d", iterations);
+    RunHash("im_hash/long_label", "Properties##inspector/transform/position/component_%d", iterations);
+
+    const int storageSizes[] = { 16, 256, 1000, 10000, 100000 };
+    for (size_t s = 0; s < sizeof(storageSizes) / sizeof(storageSizes[0]); ++s)
+    {
+        RunStorage(storageSizes[s], iterations);
+    }
+
+    ImGui::Render();
+    ShutdownImGui();
+}
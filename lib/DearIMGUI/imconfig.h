@@ -29,6 +29,15 @@
 //---- Pack colors to BGRA instead of RGBA (remove need to post process vertex buffer in back ends)
 //#define IMGUI_USE_BGRA_PACKED_COLOR
 
+//---- Don't use std::thread in ImFontAtlas::Build() (ImFontAtlas::BuildThreadCount is then ignored), for platforms without threads
+//#define IMGUI_DISABLE_THREADED_FONT_BUILD
+
+//---- Measure the CPU time, items, vertices and draw commands of every window, listed in a sortable table by ShowMetricsWindow()
+//#define IMGUI_ENABLE_WINDOW_METRICS
+
+//---- Store ImGuiStorage pairs (tree node states, window and settings indices) in a hash table rather than a sorted array; inserting into large storages no longer moves memory
+//#define IMGUI_USE_HASHED_STORAGE
+
 //---- Implement STB libraries in a namespace to avoid conflicts
 //#define IMGUI_STB_NAMESPACE     ImGuiStb
 
@@ -44,6 +53,7 @@
 */
 
 //---- Use 32-bit vertex indices (instead of default: 16-bit) to allow meshes with more than 64K vertices
+//---- The OGRE back-end (ImguiManager.cpp) picks the matching index buffer type automatically.
 //#define ImDrawIdx unsigned int
 
 //---- Tip: You can add extra functions within the ImGui:: namespace, here or in your own headers files.
@@ -629,6 +629,9 @@
 #else
 #include <stdint.h>     // intptr_t
 #endif
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+#include <chrono>       // steady_clock
+#endif
 
 #ifdef _MSC_VER
 #pragma warning (disable: 4127) // condition expression is constant
@@ -1358,6 +1361,173 @@ void* ImFileLoadToMemory(const char* filename, const char* file_open_mode, int*
 //-----------------------------------------------------------------------------
 
 // Helper: Key->value storage
+#ifdef IMGUI_USE_HASHED_STORAGE
+
+// Open addressing with linear probing. Data holds a power of two number of slots, plus one extra slot at the end for key 0,
+// since key 0 marks the empty slots.
+static inline int StorageCapacity(const ImGuiStorage& storage)
+{
+    return storage.Data.Size > 0 ? storage.Data.Size - 1 : 0;
+}
+
+static inline int StorageSlot(ImGuiID key, int capacity)
+{
+    // IDs are hashes already, but user keys may be small consecutive integers: spread them before masking
+    ImU32 h = key * 0x9E3779B1u;
+    return (int)((h ^ (h >> 15)) & (ImU32)(capacity - 1));
+}
+
+static ImGuiStorage::Pair* StorageFind(const ImGuiStorage& storage, ImGuiID key)
+{
+    const int capacity = StorageCapacity(storage);
+    if (capacity == 0)
+        return NULL;
+    ImGuiStorage::Pair* data = const_cast<ImGuiStorage::Pair*>(storage.Data.Data);
+    if (key == 0)
+        return storage.ZeroKeyUsed ? &data[capacity] : NULL;
+    for (int i = StorageSlot(key, capacity); ; i = (i + 1) & (capacity - 1)) // The table is never full, an empty slot ends the probe
+    {
+        if (data[i].key == key)
+            return &data[i];
+        if (data[i].key == 0)
+            return NULL;
+    }
+}
+
+static ImGuiStorage::Pair* StorageFindEmptySlot(ImGuiStorage& storage, ImGuiID key)
+{
+    const int capacity = StorageCapacity(storage);
+    int i = StorageSlot(key, capacity);
+    while (storage.Data[i].key != 0)
+        i = (i + 1) & (capacity - 1);
+    return &storage.Data[i];
+}
+
+static void StorageRehash(ImGuiStorage& storage, int new_capacity)
+{
+    ImVector<ImGuiStorage::Pair> old_data;
+    old_data.swap(storage.Data);
+    storage.Data.reserve(new_capacity + 1);
+    storage.Data.resize(new_capacity + 1);
+    for (int i = 0; i < storage.Data.Size; i++)
+        storage.Data[i].key = 0;
+
+    const int old_capacity = old_data.Size > 0 ? old_data.Size - 1 : 0;
+    for (int i = 0; i < old_capacity; i++)
+        if (old_data[i].key != 0)
+            *StorageFindEmptySlot(storage, old_data[i].key) = old_data[i];
+    if (storage.ZeroKeyUsed)
+        storage.Data[new_capacity] = old_data[old_capacity];
+}
+
+// Adds a pair for a key known to be missing, its value is left for the caller to set
+static ImGuiStorage::Pair* StorageAdd(ImGuiStorage& storage, ImGuiID key)
+{
+    const int capacity = StorageCapacity(storage);
+    if ((storage.Count + 1) * 4 > capacity * 3) // Load factor kept under 3/4, probes stay short
+        StorageRehash(storage, capacity > 0 ? capacity * 2 : 16);
+    storage.Count++;
+    if (key == 0)
+    {
+        storage.ZeroKeyUsed = true;
+        return &storage.Data.back();
+    }
+    ImGuiStorage::Pair* pair = StorageFindEmptySlot(storage, key);
+    pair->key = key;
+    return pair;
+}
+
+void ImGuiStorage::Clear()
+{
+    Data.clear();
+    Count = 0;
+    ZeroKeyUsed = false;
+}
+
+int ImGuiStorage::GetInt(ImGuiID key, int default_val) const
+{
+    const Pair* pair = StorageFind(*this, key);
+    return pair ? pair->val_i : default_val;
+}
+
+bool ImGuiStorage::GetBool(ImGuiID key, bool default_val) const
+{
+    return GetInt(key, default_val ? 1 : 0) != 0;
+}
+
+float ImGuiStorage::GetFloat(ImGuiID key, float default_val) const
+{
+    const Pair* pair = StorageFind(*this, key);
+    return pair ? pair->val_f : default_val;
+}
+
+void* ImGuiStorage::GetVoidPtr(ImGuiID key) const
+{
+    const Pair* pair = StorageFind(*this, key);
+    return pair ? pair->val_p : NULL;
+}
+
+// References are only valid until a new value is added to the storage. Calling a Set***() function or a Get***Ref() function invalidates the pointer.
+int* ImGuiStorage::GetIntRef(ImGuiID key, int default_val)
+{
+    Pair* pair = StorageFind(*this, key);
+    if (!pair)
+    {
+        pair = StorageAdd(*this, key);
+        pair->val_i = default_val;
+    }
+    return &pair->val_i;
+}
+
+bool* ImGuiStorage::GetBoolRef(ImGuiID key, bool default_val)
+{
+    return (bool*)GetIntRef(key, default_val ? 1 : 0);
+}
+
+float* ImGuiStorage::GetFloatRef(ImGuiID key, float default_val)
+{
+    Pair* pair = StorageFind(*this, key);
+    if (!pair)
+    {
+        pair = StorageAdd(*this, key);
+        pair->val_f = default_val;
+    }
+    return &pair->val_f;
+}
+
+void** ImGuiStorage::GetVoidPtrRef(ImGuiID key, void* default_val)
+{
+    Pair* pair = StorageFind(*this, key);
+    if (!pair)
+    {
+        pair = StorageAdd(*this, key);
+        pair->val_p = default_val;
+    }
+    return &pair->val_p;
+}
+
+void ImGuiStorage::SetInt(ImGuiID key, int val)
+{
+    *GetIntRef(key) = val;
+}
+
+void ImGuiStorage::SetBool(ImGuiID key, bool val)
+{
+    SetInt(key, val ? 1 : 0);
+}
+
+void ImGuiStorage::SetFloat(ImGuiID key, float val)
+{
+    *GetFloatRef(key) = val;
+}
+
+void ImGuiStorage::SetVoidPtr(ImGuiID key, void* val)
+{
+    *GetVoidPtrRef(key) = val;
+}
+
+#else
+
 void ImGuiStorage::Clear()
 {
     Data.clear();
@@ -1484,8 +1654,11 @@ void ImGuiStorage::SetVoidPtr(ImGuiID key, void* val)
     it->val_p = val;
 }
 
+#endif // IMGUI_USE_HASHED_STORAGE
+
 void ImGuiStorage::SetAllInt(int v)
 {
+    // With IMGUI_USE_HASHED_STORAGE this writes the empty slots too, which is harmless
     for (int i = 0; i < Data.Size; i++)
         Data[i].val_i = v;
 }
@@ -1808,6 +1981,9 @@ ImGuiWindow::ImGuiWindow(const char* name)
     FocusIdxAllCounter = FocusIdxTabCounter = -1;
     FocusIdxAllRequestCurrent = FocusIdxTabRequestCurrent = INT_MAX;
     FocusIdxAllRequestNext = FocusIdxTabRequestNext = INT_MAX;
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+    MetricsSegmentStart = 0.0;
+#endif
 }
 
 ImGuiWindow::~ImGuiWindow()
@@ -1924,6 +2100,9 @@ void ImGui::ItemSize(const ImRect& bb, float text_offset_y)
 bool ImGui::ItemAdd(const ImRect& bb, const ImGuiID* id)
 {
     ImGuiWindow* window = GetCurrentWindow();
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+    window->MetricsCurrent.ItemCount++;
+#endif
     window->DC.LastItemId = id ? *id : 0;
     window->DC.LastItemRect = bb;
     window->DC.LastItemHoveredAndUsable = window->DC.LastItemHoveredRect = false;
@@ -2146,6 +2325,7 @@ void ImGui::NewFrame()
         g.Initialized = true;
     }
 
+    g.IO.Fonts->UpdateDynamicTexture(); // Between frames, as growing the atlas moves the texture coordinates of every glyph
     SetCurrentFont(GetDefaultFont());
     IM_ASSERT(g.Font->IsLoaded());
 
@@ -2342,6 +2522,10 @@ void ImGui::NewFrame()
         window->WasActive = window->Active;
         window->Active = false;
         window->Accessed = false;
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+        window->Metrics = (window->LastFrameActive == g.FrameCount - 1) ? window->MetricsCurrent : ImGuiWindowMetrics(); // Begun last frame, maybe clipped/hidden since
+        window->MetricsCurrent = ImGuiWindowMetrics();
+#endif
     }
 
     // Closing the focused window restore focus to the first active root window in descending z-order
@@ -2385,6 +2569,7 @@ void ImGui::Shutdown()
         ImGui::MemFree(g.Windows[i]);
     }
     g.Windows.clear();
+    g.WindowsById.Clear();
     g.WindowsSortBuffer.clear();
     g.CurrentWindow = NULL;
     g.CurrentWindowStack.clear();
@@ -2396,6 +2581,7 @@ void ImGui::Shutdown()
     for (int i = 0; i < g.Settings.Size; i++)
         ImGui::MemFree(g.Settings[i].Name);
     g.Settings.clear();
+    g.SettingsById.Clear();
     g.ColorModifiers.clear();
     g.StyleModifiers.clear();
     g.FontStack.clear();
@@ -2433,14 +2619,8 @@ void ImGui::Shutdown()
 static ImGuiIniData* FindWindowSettings(const char* name)
 {
     ImGuiContext& g = *GImGui;
-    ImGuiID id = ImHash(name, 0);
-    for (int i = 0; i != g.Settings.Size; i++)
-    {
-        ImGuiIniData* ini = &g.Settings[i];
-        if (ini->Id == id)
-            return ini;
-    }
-    return NULL;
+    int index = g.SettingsById.GetInt(ImHash(name, 0), 0) - 1; // Index rather than pointer: Settings moves when it grows
+    return index >= 0 ? &g.Settings[index] : NULL;
 }
 
 static ImGuiIniData* AddWindowSettings(const char* name)
@@ -2449,6 +2629,7 @@ static ImGuiIniData* AddWindowSettings(const char* name)
     ImGuiIniData* ini = &GImGui->Settings.back();
     ini->Name = ImStrdup(name);
     ini->Id = ImHash(name, 0);
+    GImGui->SettingsById.SetInt(ini->Id, GImGui->Settings.Size);
     ini->Collapsed = false;
     ini->Pos = ImVec2(FLT_MAX,FLT_MAX);
     ini->Size = ImVec2(0,0);
@@ -2602,7 +2783,7 @@ static void AddDrawListToRenderList(ImVector<ImDrawList*>& out_render_list, ImDr
     IM_ASSERT((int)draw_list->_VtxCurrentIdx == draw_list->VtxBuffer.Size);
 
     // Check that draw_list doesn't use more vertices than indexable (default ImDrawIdx = 2 bytes = 64K vertices)
-    // If this assert triggers because you are drawing lots of stuff manually, A) workaround by calling BeginChild()/EndChild() to put your draw commands in multiple draw lists, B) #define ImDrawIdx to a 'unsigned int' in imconfig.h and render accordingly.
+    // If this assert triggers because you are drawing lots of stuff manually, A) workaround by calling BeginChild()/EndChild() to put your draw commands in multiple draw lists, B) #define ImDrawIdx to a 'unsigned int' in imconfig.h and render accordingly (the OGRE back-end handles both index sizes).
     IM_ASSERT((int64_t)draw_list->_VtxCurrentIdx <= ((int64_t)1L << (sizeof(ImDrawIdx)*8)));  // Too many vertices in same ImDrawList. See comment above.
     
     out_render_list.push_back(draw_list);
@@ -2610,6 +2791,20 @@ static void AddDrawListToRenderList(ImVector<ImDrawList*>& out_render_list, ImDr
     GImGui->IO.MetricsRenderIndices += draw_list->IdxBuffer.Size;
 }
 
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+static double GetWindowMetricsTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Time since 'window' became the current window goes to its metrics
+static void AccumulateWindowMetricsTime(ImGuiWindow* window, double now)
+{
+    if (window)
+        window->MetricsCurrent.Time += (float)(now - window->MetricsSegmentStart);
+}
+#endif
+
 static void AddWindowToRenderList(ImVector<ImDrawList*>& out_render_list, ImGuiWindow* window)
 {
     AddDrawListToRenderList(out_render_list, window->DrawList);
@@ -2744,6 +2939,17 @@ void ImGui::Render()
             }
         }
 
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+        // Draw lists are final now; back-ends may take their buffers over once Render() returns
+        for (int i = 0; i != g.Windows.Size; i++)
+        {
+            ImGuiWindow* window = g.Windows[i];
+            const bool rendered = window->Active && window->HiddenFrames <= 0;
+            window->MetricsCurrent.VtxCount = rendered ? window->DrawList->VtxBuffer.Size : 0;
+            window->MetricsCurrent.CmdCount = rendered ? window->DrawList->CmdBuffer.Size : 0;
+        }
+#endif
+
         // Flatten layers
         int n = g.RenderDrawLists[0].Size;
         int flattened_size = n;
@@ -3760,13 +3966,8 @@ static ImVec2 FindBestPopupWindowPos(const ImVec2& base_pos, const ImVec2& size,
 
 ImGuiWindow* ImGui::FindWindowByName(const char* name)
 {
-    // FIXME-OPT: Store sorted hashes -> pointers so we can do a bissection in a contiguous block
     ImGuiContext& g = *GImGui;
-    ImGuiID id = ImHash(name, 0);
-    for (int i = 0; i < g.Windows.Size; i++)
-        if (g.Windows[i]->ID == id)
-            return g.Windows[i];
-    return NULL;
+    return (ImGuiWindow*)g.WindowsById.GetVoidPtr(ImHash(name, 0));
 }
 
 static ImGuiWindow* CreateNewWindow(const char* name, ImVec2 size, ImGuiWindowFlags flags)
@@ -3832,6 +4033,7 @@ static ImGuiWindow* CreateNewWindow(const char* name, ImVec2 size, ImGuiWindowFl
         g.Windows.insert(g.Windows.begin(), window); // Quite slow but rare and only once
     else
         g.Windows.push_back(window);
+    g.WindowsById.SetVoidPtr(window->ID, window);
     return window;
 }
 
@@ -3881,6 +4083,10 @@ bool ImGui::Begin(const char* name, bool* p_open, const ImVec2& size_on_first_us
     IM_ASSERT(name != NULL);                        // Window name required
     IM_ASSERT(g.Initialized);                       // Forgot to call ImGui::NewFrame()
     IM_ASSERT(g.FrameCountEnded != g.FrameCount);   // Called ImGui::Render() or ImGui::EndFrame() and haven't called ImGui::NewFrame() again yet
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+    const double metrics_begin_time = GetWindowMetricsTime();
+    AccumulateWindowMetricsTime(g.CurrentWindow, metrics_begin_time); // The parent window pauses until End()
+#endif
 
     if (flags & ImGuiWindowFlags_NoInputs)
         flags |= ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize;
@@ -3900,6 +4106,9 @@ bool ImGui::Begin(const char* name, bool* p_open, const ImVec2& size_on_first_us
         window->Flags = (ImGuiWindowFlags)flags;
     else
         flags = window->Flags;
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+    window->MetricsSegmentStart = metrics_begin_time;
+#endif
 
     // Add to stack
     ImGuiWindow* parent_window = !g.CurrentWindowStack.empty() ? g.CurrentWindowStack.back() : NULL;
@@ -4451,6 +4660,13 @@ void ImGui::End()
         g.CurrentPopupStack.pop_back();
     CheckStacksSize(window, false);
     SetCurrentWindow(g.CurrentWindowStack.empty() ? NULL : g.CurrentWindowStack.back());
+
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+    const double metrics_end_time = GetWindowMetricsTime();
+    AccumulateWindowMetricsTime(window, metrics_end_time);
+    if (g.CurrentWindow)
+        g.CurrentWindow->MetricsSegmentStart = metrics_end_time; // The parent window resumes
+#endif
 }
 
 // Vertical scrollbar
@@ -9725,6 +9941,28 @@ static void ImeSetInputScreenPosFn_DefaultImpl(int, int) {}
 // HELP
 //-----------------------------------------------------------------------------
 
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+// Order of the window costs table in ShowMetricsWindow()
+static int  GWindowMetricsSortColumn = 1;
+static bool GWindowMetricsSortDescending = true;
+
+static int WindowMetricsComparer(const void* lhs, const void* rhs)
+{
+    const ImGuiWindow* a = *(const ImGuiWindow**)lhs;
+    const ImGuiWindow* b = *(const ImGuiWindow**)rhs;
+    int d = 0;
+    switch (GWindowMetricsSortColumn)
+    {
+    case 0: d = strcmp(a->Name, b->Name); break;
+    case 1: d = (a->Metrics.Time > b->Metrics.Time) - (a->Metrics.Time < b->Metrics.Time); break;
+    case 2: d = a->Metrics.ItemCount - b->Metrics.ItemCount; break;
+    case 3: d = a->Metrics.VtxCount - b->Metrics.VtxCount; break;
+    case 4: d = a->Metrics.CmdCount - b->Metrics.CmdCount; break;
+    }
+    return GWindowMetricsSortDescending ? -d : d;
+}
+#endif
+
 void ImGui::ShowMetricsWindow(bool* p_open)
 {
     if (ImGui::Begin("ImGui Metrics", p_open))
@@ -9823,6 +10061,58 @@ void ImGui::ShowMetricsWindow(bool* p_open)
 
         ImGuiContext& g = *GImGui;                // Access private state
         Funcs::NodeWindows(g.Windows, "Windows");
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+        if (ImGui::TreeNode("WindowCosts", "Window costs, previous frame"))
+        {
+            ImVector<ImGuiWindow*> windows;
+            ImGuiWindowMetrics total;
+            for (int i = 0; i < g.Windows.Size; i++)
+            {
+                ImGuiWindow* window = g.Windows[i];
+                if (window->LastFrameActive < g.FrameCount - 1)
+                    continue;
+                windows.push_back(window);
+                total.Time += window->Metrics.Time;
+                total.ItemCount += window->Metrics.ItemCount;
+                total.VtxCount += window->Metrics.VtxCount;
+                total.CmdCount += window->Metrics.CmdCount;
+            }
+            if (windows.Size > 1)
+                qsort(windows.begin(), (size_t)windows.Size, sizeof(ImGuiWindow*), WindowMetricsComparer);
+
+            // Click a header to sort by its column, again to reverse the order
+            static const char* headers[] = { "Window", "CPU ms", "Items", "Vertices", "Draw cmds" };
+            ImGui::Columns(IM_ARRAYSIZE(headers), "WindowCosts");
+            for (int c = 0; c < IM_ARRAYSIZE(headers); c++)
+            {
+                char label[64];
+                ImFormatString(label, IM_ARRAYSIZE(label), "%s%s##%d", headers[c], c != GWindowMetricsSortColumn ? "" : GWindowMetricsSortDescending ? " (v)" : " (^)", c);
+                if (ImGui::Selectable(label, c == GWindowMetricsSortColumn))
+                {
+                    GWindowMetricsSortDescending = (c == GWindowMetricsSortColumn) ? !GWindowMetricsSortDescending : (c != 0);
+                    GWindowMetricsSortColumn = c;
+                }
+                ImGui::NextColumn();
+            }
+            ImGui::Separator();
+            ImGui::Text("(total)"); ImGui::NextColumn();
+            ImGui::Text("%.3f", total.Time * 1000.0f); ImGui::NextColumn();
+            ImGui::Text("%d", total.ItemCount); ImGui::NextColumn();
+            ImGui::Text("%d", total.VtxCount); ImGui::NextColumn();
+            ImGui::Text("%d", total.CmdCount); ImGui::NextColumn();
+            for (int i = 0; i < windows.Size; i++)
+            {
+                const ImGuiWindowMetrics& metrics = windows[i]->Metrics;
+                ImGui::Text("%s", windows[i]->Name); ImGui::NextColumn();
+                ImGui::Text("%.3f", metrics.Time * 1000.0f); ImGui::NextColumn();
+                ImGui::Text("%d", metrics.ItemCount); ImGui::NextColumn();
+                ImGui::Text("%d", metrics.VtxCount); ImGui::NextColumn();
+                ImGui::Text("%d", metrics.CmdCount); ImGui::NextColumn();
+            }
+            ImGui::Columns(1);
+            ImGui::TreePop();
+        }
+#endif
         if (ImGui::TreeNode("DrawList", "Active DrawLists (%d)", g.RenderDrawLists[0].Size))
         {
             for (int i = 0; i < g.RenderDrawLists[0].Size; i++)
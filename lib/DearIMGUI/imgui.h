@@ -970,11 +970,23 @@ struct ImGuiStorage
         Pair(ImGuiID _key, void* _val_p) { key = _key; val_p = _val_p; }
     };
     ImVector<Pair>      Data;
+#ifdef IMGUI_USE_HASHED_STORAGE
+    int                 Count;          // Pairs stored, Data holds more slots than that
+    bool                ZeroKeyUsed;    // Key 0 marks the empty slots, its pair is kept in the last slot of Data
+
+    ImGuiStorage() { Count = 0; ZeroKeyUsed = false; }
+#endif
 
     // - Get***() functions find pair, never add/allocate. Pairs are sorted so a query is O(log N)
     // - Set***() functions find pair, insertion on demand if missing.
     // - Sorted insertion is costly, paid once. A typical frame shouldn't need to insert any new pair.
+    // - With IMGUI_USE_HASHED_STORAGE, Data is an open addressing hash table instead: queries and insertions are O(1), pairs are in no particular order.
     IMGUI_API void      Clear();
+#ifdef IMGUI_USE_HASHED_STORAGE
+    int                 GetCount() const { return Count; }      // Number of pairs stored, in either mode
+#else
+    int                 GetCount() const { return Data.Size; }
+#endif
     IMGUI_API int       GetInt(ImGuiID key, int default_val = 0) const;
     IMGUI_API void      SetInt(ImGuiID key, int val);
     IMGUI_API bool      GetBool(ImGuiID key, bool default_val = false) const;
@@ -1313,6 +1325,8 @@ struct ImFontAtlas
     IMGUI_API void              GetTexDataAsAlpha8(unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel = NULL);  // 1 byte per-pixel
     IMGUI_API void              GetTexDataAsRGBA32(unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel = NULL);  // 4 bytes-per-pixel
     void                        SetTexID(void* id)  { TexID = id; }
+    bool                        IsTexDirty() const  { return TexDirtyRect.x < TexDirtyRect.z; }
+    void                        ClearTexDirtyRect() { TexDirtyRect = ImVec4(0, 0, 0, 0); }                  // Call once the pixels in TexDirtyRect have been uploaded
 
     // Helpers to retrieve list of common Unicode ranges (2 value per range, values are inclusive, zero-terminated list)
     // NB: Make sure that your string are UTF-8 and NOT in your local code page. See FAQ for details.
@@ -1331,12 +1345,22 @@ struct ImFontAtlas
     int                         TexWidth;           // Texture width calculated during Build().
     int                         TexHeight;          // Texture height calculated during Build().
     int                         TexDesiredWidth;    // Texture width desired by user before Build(). Must be a power-of-two. If have many glyphs your graphics API have texture size restrictions you may want to increase texture width to decrease height.
+    int                         BuildThreadCount;   // = 1      // Threads rendering glyphs in Build(), including the calling one. 0: one per hardware thread. Above 1, io.MemAllocFn/MemFreeFn must be thread-safe (malloc/free are).
+    bool                        DistanceFieldGlyphs;// = false  // Set before Build() to store glyphs as signed distance fields (0.5 on the outline, rising inside), which stay sharp at any font scale. Needs a renderer that thresholds the texture with bilinear filtering. OversampleH/V are ignored.
+    int                         DistanceFieldSpread;// = 4      // Distance in texels covered by a distance field glyph on each side of its outline. Larger values allow thicker outlines/glows but need more atlas space.
     ImVec2                      TexUvWhitePixel;    // Texture coordinates to a white pixel
+    ImVec4                      TexDirtyRect;       // Pixels changed since ClearTexDirtyRect(), as (x0,y0,x1,y1). Empty when x0 >= x1.
+    bool                        DynamicGlyphs;      // = false  // Set before Build() to rasterize glyphs the first time ImFont::FindGlyph() looks them up, instead of every glyph of the ranges. The texture then changes at runtime: keep the pixels (don't call ClearTexData()/ClearInputData()), upload TexDirtyRect after each frame and resize the texture when TexHeight grew.
     ImVector<ImFont*>           Fonts;              // Hold all the fonts returned by AddFont*. Fonts[0] is the default font upon calling ImGui::NewFrame(), use ImGui::PushFont()/PopFont() to change the current font.
 
     // Private
     ImVector<ImFontConfig>      ConfigData;         // Internal data
+    void*                       DynamicData;        // Internal data kept by Build() when DynamicGlyphs is set (packing context, parsed fonts)
     IMGUI_API bool              Build();            // Build pixels data. This is automatically for you by the GetTexData*** functions.
+    IMGUI_API bool              BuildDynamic();
+    IMGUI_API void              ClearDynamicData();
+    IMGUI_API bool              LoadDynamicGlyph(ImFont* font, ImWchar c);  // Rasterize a glyph into the atlas, called by ImFont::FindGlyph(). False when the atlas is full, the glyph keeps rendering as the fallback glyph until UpdateDynamicTexture() made room.
+    IMGUI_API void              UpdateDynamicTexture();                     // Grow the texture when glyphs didn't fit during the last frame, called by ImGui::NewFrame()
     IMGUI_API void              RenderCustomTexData(int pass, void* rects);
 };
 
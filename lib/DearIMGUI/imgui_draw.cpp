@@ -27,6 +27,10 @@
 #include <alloca.h>     // alloca
 #endif
 #endif
+#ifndef IMGUI_DISABLE_THREADED_FONT_BUILD
+#include <atomic>       // ImFontAtlas::BuildThreadCount
+#include <thread>
+#endif
 
 #ifdef _MSC_VER
 #pragma warning (disable: 4505) // unreferenced local function has been removed (stb stuff)
@@ -86,8 +90,9 @@ namespace IMGUI_STB_NAMESPACE
 #endif
 #include "stb_rect_pack.h"
 
-#define STBTT_malloc(x,u)  ((void)(u), ImGui::MemAlloc(x))
-#define STBTT_free(x,u)    ((void)(u), ImGui::MemFree(x))
+// Glyphs rendered on worker threads (ImFontAtlas::BuildThreadCount) pass their ImGuiIO as allocation context: the allocator is called directly, leaving out the non-atomic MetricsAllocs counter
+#define STBTT_malloc(x,u)  ((u) ? ((ImGuiIO*)(u))->MemAllocFn(x) : ImGui::MemAlloc(x))
+#define STBTT_free(x,u)    ((u) ? ((ImGuiIO*)(u))->MemFreeFn(x) : ImGui::MemFree(x))
 #define STBTT_assert(x)    IM_ASSERT(x)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION
 #define STBTT_STATIC
@@ -562,7 +567,7 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
                 _VtxWritePtr += 4;
             }
         }
-        _VtxCurrentIdx += (ImDrawIdx)vtx_count;
+        _VtxCurrentIdx += (unsigned int)vtx_count;
     }
     else
     {
@@ -656,7 +661,7 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
             _IdxWritePtr[3] = (ImDrawIdx)(vtx_outer_idx+(i0<<1)); _IdxWritePtr[4] = (ImDrawIdx)(vtx_outer_idx+(i1<<1)); _IdxWritePtr[5] = (ImDrawIdx)(vtx_inner_idx+(i1<<1));
             _IdxWritePtr += 6;
         }
-        _VtxCurrentIdx += (ImDrawIdx)vtx_count;
+        _VtxCurrentIdx += (unsigned int)vtx_count;
     }
     else
     {
@@ -674,7 +679,7 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
             _IdxWritePtr[0] = (ImDrawIdx)(_VtxCurrentIdx); _IdxWritePtr[1] = (ImDrawIdx)(_VtxCurrentIdx+i-1); _IdxWritePtr[2] = (ImDrawIdx)(_VtxCurrentIdx+i);
             _IdxWritePtr += 3;
         }
-        _VtxCurrentIdx += (ImDrawIdx)vtx_count;
+        _VtxCurrentIdx += (unsigned int)vtx_count;
     }
 }
 
@@ -1057,6 +1062,12 @@ ImFontAtlas::ImFontAtlas()
     TexPixelsRGBA32 = NULL;
     TexWidth = TexHeight = TexDesiredWidth = 0;
     TexUvWhitePixel = ImVec2(0, 0);
+    TexDirtyRect = ImVec4(0, 0, 0, 0);
+    BuildThreadCount = 1;
+    DistanceFieldGlyphs = false;
+    DistanceFieldSpread = 4;
+    DynamicGlyphs = false;
+    DynamicData = NULL;
 }
 
 ImFontAtlas::~ImFontAtlas()
@@ -1066,6 +1077,7 @@ ImFontAtlas::~ImFontAtlas()
 
 void    ImFontAtlas::ClearInputData()
 {
+    ClearDynamicData(); // Rasterizes from the TTF data
     for (int i = 0; i < ConfigData.Size; i++)
         if (ConfigData[i].FontData && ConfigData[i].FontDataOwnedByAtlas)
         {
@@ -1085,6 +1097,7 @@ void    ImFontAtlas::ClearInputData()
 
 void    ImFontAtlas::ClearTexData()
 {
+    ClearDynamicData(); // Rasterizes into TexPixelsAlpha8
     if (TexPixelsAlpha8)
         ImGui::MemFree(TexPixelsAlpha8);
     if (TexPixelsRGBA32)
@@ -1267,6 +1280,175 @@ ImFont* ImFontAtlas::AddFontFromMemoryCompressedBase85TTF(const char* compressed
     return font;
 }
 
+// Signed distance field glyphs (ImFontAtlas::DistanceFieldGlyphs)
+// Each glyph is rasterized at DISTANCE_FIELD_SUPERSAMPLE times its size, a distance transform gives every sample its distance to the
+// outline, and each texel stores the average distance of its samples: 128 on the outline, up to 255 'spread' texels inside, down to 0 outside.
+static const int DISTANCE_FIELD_SUPERSAMPLE = 4;
+static const float DISTANCE_FIELD_FAR = 1e20f;
+
+// Squared Euclidean distance transform of a sampled function, in one dimension (Felzenszwalb & Huttenlocher).
+// d[q] = min over p of (q - p)^2 + f[p]. 'v' holds n ints and 'z' n + 1 floats of scratch space.
+static void DistanceTransform1D(const float* f, float* d, int n, int* v, float* z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -DISTANCE_FIELD_FAR;
+    z[1] = +DISTANCE_FIELD_FAR;
+    for (int q = 1; q < n; q++)
+    {
+        float s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+        while (s <= z[k])
+        {
+            k--;
+            s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = +DISTANCE_FIELD_FAR;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++)
+    {
+        while (z[k + 1] < (float)q)
+            k++;
+        d[q] = (float)((q - v[k]) * (q - v[k])) + f[v[k]];
+    }
+}
+
+// In place: 'grid' holds 0 at the samples to measure from and DISTANCE_FIELD_FAR elsewhere, on return their squared distance
+static void DistanceTransform2D(float* grid, int w, int h, float* f, float* d, int* v, float* z)
+{
+    for (int x = 0; x < w; x++)
+    {
+        for (int y = 0; y < h; y++)
+            f[y] = grid[y * w + x];
+        DistanceTransform1D(f, d, h, v, z);
+        for (int y = 0; y < h; y++)
+            grid[y * w + x] = d[y];
+    }
+    for (int y = 0; y < h; y++)
+    {
+        memcpy(f, grid + y * w, w * sizeof(float));
+        DistanceTransform1D(f, grid + y * w, w, v, z);
+    }
+}
+
+// Same contract as stbtt_PackFontRangesRenderIntoRects(), rects come from stbtt_PackFontRangesGatherRects() without oversampling, grown by 2 * spread
+static void RenderDistanceFieldIntoRects(stbtt_pack_context* spc, const stbtt_fontinfo* info, stbtt_pack_range* ranges, int num_ranges, stbrp_rect* rects, int spread)
+{
+    const int ss = DISTANCE_FIELD_SUPERSAMPLE;
+    for (int i = 0, k = 0; i < num_ranges; i++)
+    {
+        const float fh = ranges[i].font_size;
+        const float scale = fh > 0 ? stbtt_ScaleForPixelHeight(info, fh) : stbtt_ScaleForMappingEmToPixels(info, -fh);
+        for (int j = 0; j < ranges[i].num_chars; j++, k++)
+        {
+            const stbrp_rect& r = rects[k];
+            if (!r.was_packed)
+                continue;
+            const int codepoint = ranges[i].array_of_unicode_codepoints == NULL ? ranges[i].first_unicode_codepoint_in_range + j : ranges[i].array_of_unicode_codepoints[j];
+            const int glyph = stbtt_FindGlyphIndex(info, codepoint);
+            int x0, y0, x1, y1, hx0, hy0, hx1, hy1, advance, left_side_bearing;
+            stbtt_GetGlyphHMetrics(info, glyph, &advance, &left_side_bearing);
+            stbtt_GetGlyphBitmapBox(info, glyph, scale, scale, &x0, &y0, &x1, &y1);
+            stbtt_GetGlyphBitmapBox(info, glyph, scale * ss, scale * ss, &hx0, &hy0, &hx1, &hy1);
+
+            // Texels of the glyph box plus 'spread' on every side, and the samples covering them
+            const int tex_w = (x1 - x0) + spread * 2, tex_h = (y1 - y0) + spread * 2;
+            const int w = tex_w * ss, h = tex_h * ss;
+            const int n = ImMax(w, h);
+            unsigned char* coverage = (unsigned char*)STBTT_malloc((size_t)(w * h), info->userdata);
+            float* dist_inside = (float*)STBTT_malloc((size_t)(w * h) * sizeof(float), info->userdata);
+            float* dist_outside = (float*)STBTT_malloc((size_t)(w * h) * sizeof(float), info->userdata);
+            float* scratch = (float*)STBTT_malloc((size_t)(n * 3 + 1) * sizeof(float), info->userdata);
+            int* scratch_v = (int*)STBTT_malloc((size_t)n * sizeof(int), info->userdata);
+            memset(coverage, 0, (size_t)(w * h));
+            const int ox = hx0 - (x0 - spread) * ss, oy = hy0 - (y0 - spread) * ss; // The supersampled box lies within the texel box
+            if (hx1 > hx0 && hy1 > hy0)
+                stbtt_MakeGlyphBitmap(info, coverage + oy * w + ox, hx1 - hx0, hy1 - hy0, w, scale * ss, scale * ss, glyph);
+
+            for (int p = 0; p < w * h; p++)
+            {
+                const bool inside = coverage[p] >= 128;
+                dist_inside[p] = inside ? 0.0f : DISTANCE_FIELD_FAR;    // Distance to the glyph, for samples outside
+                dist_outside[p] = inside ? DISTANCE_FIELD_FAR : 0.0f;   // Distance to the background, for samples inside
+            }
+            DistanceTransform2D(dist_inside, w, h, scratch, scratch + n, scratch_v, scratch + n * 2);
+            DistanceTransform2D(dist_outside, w, h, scratch, scratch + n, scratch_v, scratch + n * 2);
+
+            for (int ty = 0; ty < tex_h; ty++)
+                for (int tx = 0; tx < tex_w; tx++)
+                {
+                    // Signed distance in samples, negative inside; the outline lies half a sample away from the sample centers
+                    float sum = 0.0f;
+                    for (int sy = ty * ss; sy < (ty + 1) * ss; sy++)
+                        for (int sx = tx * ss; sx < (tx + 1) * ss; sx++)
+                        {
+                            const int p = sy * w + sx;
+                            sum += (coverage[p] >= 128) ? 0.5f - sqrtf(dist_outside[p]) : sqrtf(dist_inside[p]) - 0.5f;
+                        }
+                    const float dist = sum / (float)(ss * ss * ss); // In texels
+                    const float value = 128.0f - dist * 128.0f / (float)spread;
+                    spc->pixels[(r.y + ty) * spc->stride_in_bytes + r.x + tx] = (unsigned char)ImClamp(value + 0.5f, 0.0f, 255.0f);
+                }
+
+            STBTT_free(scratch_v, info->userdata);
+            STBTT_free(scratch, info->userdata);
+            STBTT_free(dist_outside, info->userdata);
+            STBTT_free(dist_inside, info->userdata);
+            STBTT_free(coverage, info->userdata);
+
+            // Quad covers the spread, so the field fades out within it
+            stbtt_packedchar* bc = &ranges[i].chardata_for_range[j];
+            bc->x0 = (unsigned short)r.x;
+            bc->y0 = (unsigned short)r.y;
+            bc->x1 = (unsigned short)(r.x + tex_w);
+            bc->y1 = (unsigned short)(r.y + tex_h);
+            bc->xadvance = scale * advance;
+            bc->xoff = (float)(x0 - spread);
+            bc->yoff = (float)(y0 - spread);
+            bc->xoff2 = (float)(x0 - spread + tex_w);
+            bc->yoff2 = (float)(y0 - spread + tex_h);
+        }
+    }
+}
+
+// Packing rectangles of the glyphs gathered by stbtt_PackFontRangesGatherRects(), room for the distance field around each glyph
+static void GrowRectsForDistanceField(stbrp_rect* rects, int rects_count, int spread)
+{
+    for (int i = 0; i < rects_count; i++)
+    {
+        rects[i].w = (stbrp_coord)(rects[i].w + spread * 2);
+        rects[i].h = (stbrp_coord)(rects[i].h + spread * 2);
+    }
+}
+
+static void RenderGlyphsIntoRects(stbtt_pack_context* spc, const stbtt_fontinfo* info, stbtt_pack_range* ranges, int num_ranges, stbrp_rect* rects, int distance_field_spread)
+{
+    if (distance_field_spread > 0)
+        RenderDistanceFieldIntoRects(spc, info, ranges, num_ranges, rects, distance_field_spread);
+    else
+        stbtt_PackFontRangesRenderIntoRects(spc, info, ranges, num_ranges, rects);
+}
+
+#ifndef IMGUI_DISABLE_THREADED_FONT_BUILD
+// A slice of a glyph range rendered by Build() on one of its threads
+struct ImFontBuildRenderJob
+{
+    stbtt_fontinfo      FontInfo;
+    stbtt_pack_range    Range;
+    stbrp_rect*         Rects;
+};
+
+// Takes the pack context by value: rendering temporarily changes its oversampling fields
+static void RenderGlyphJobs(stbtt_pack_context spc, ImFontBuildRenderJob* jobs, int jobs_count, std::atomic<int>* next_job, int distance_field_spread)
+{
+    for (int job_n = (*next_job)++; job_n < jobs_count; job_n = (*next_job)++)
+        RenderGlyphsIntoRects(&spc, &jobs[job_n].FontInfo, &jobs[job_n].Range, 1, jobs[job_n].Rects, distance_field_spread);
+}
+#endif
+
 bool    ImFontAtlas::Build()
 {
     IM_ASSERT(ConfigData.Size > 0);
@@ -1275,6 +1457,8 @@ bool    ImFontAtlas::Build()
     TexWidth = TexHeight = 0;
     TexUvWhitePixel = ImVec2(0, 0);
     ClearTexData();
+    if (DynamicGlyphs)
+        return BuildDynamic();
 
     struct ImFontTempBuildData
     {
@@ -1298,6 +1482,7 @@ bool    ImFontAtlas::Build()
         IM_ASSERT(font_offset >= 0);
         if (!stbtt_InitFont(&tmp.FontInfo, (unsigned char*)cfg.FontData, font_offset))
             return false;
+        tmp.FontInfo.userdata = NULL; // Allocation context, see STBTT_malloc
 
         // Count glyphs
         if (!cfg.GlyphRanges)
@@ -1313,6 +1498,8 @@ bool    ImFontAtlas::Build()
     // After packing is done, width shouldn't matter much, but some API/GPU have texture size limitations and increasing width can decrease height.
     TexWidth = (TexDesiredWidth > 0) ? TexDesiredWidth : (total_glyph_count > 4000) ? 4096 : (total_glyph_count > 2000) ? 2048 : (total_glyph_count > 1000) ? 1024 : 512;
     TexHeight = 0;
+    const int distance_field_spread = DistanceFieldGlyphs ? DistanceFieldSpread : 0;
+    IM_ASSERT(!DistanceFieldGlyphs || DistanceFieldSpread > 0);
     const int max_tex_height = 1024*32;
     stbtt_pack_context spc;
     stbtt_PackBegin(&spc, NULL, TexWidth, max_tex_height, 0, 1, NULL);
@@ -1366,8 +1553,13 @@ bool    ImFontAtlas::Build()
         // Pack
         tmp.Rects = buf_rects + buf_rects_n;
         buf_rects_n += glyph_count;
-        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+        if (distance_field_spread > 0)
+            stbtt_PackSetOversampling(&spc, 1, 1); // A distance field is filtered smoothly at any scale already
+        else
+            stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
         int n = stbtt_PackFontRangesGatherRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
+        if (distance_field_spread > 0)
+            GrowRectsForDistanceField(tmp.Rects, n, distance_field_spread);
         stbrp_pack_rects((stbrp_context*)spc.pack_info, tmp.Rects, n);
 
         // Extend texture height
@@ -1387,12 +1579,56 @@ bool    ImFontAtlas::Build()
     spc.height = TexHeight;
 
     // Second pass: render characters
+#ifndef IMGUI_DISABLE_THREADED_FONT_BUILD
+    const int thread_count = (BuildThreadCount > 0) ? BuildThreadCount : (int)std::thread::hardware_concurrency();
+    if (thread_count > 1)
+    {
+        // Every glyph has its own rectangle, so they can be rendered in any order and concurrently.
+        // Split the ranges into slices, so that a single large range (e.g. CJK) is shared between threads too.
+        const int glyphs_per_job = 256;
+        ImVector<ImFontBuildRenderJob> jobs;
+        for (int input_i = 0; input_i < ConfigData.Size; input_i++)
+        {
+            ImFontTempBuildData& tmp = tmp_array[input_i];
+            stbrp_rect* range_rects = tmp.Rects;
+            for (int i = 0; i < tmp.RangesCount; i++)
+            {
+                const stbtt_pack_range& range = tmp.Ranges[i];
+                for (int char_idx = 0; char_idx < range.num_chars; char_idx += glyphs_per_job)
+                {
+                    jobs.resize(jobs.Size + 1);
+                    ImFontBuildRenderJob& job = jobs.back();
+                    job.FontInfo = tmp.FontInfo;
+                    job.FontInfo.userdata = &ImGui::GetIO(); // See STBTT_malloc
+                    job.Range = range;
+                    job.Range.first_unicode_codepoint_in_range += char_idx;
+                    job.Range.num_chars = ImMin(glyphs_per_job, range.num_chars - char_idx);
+                    job.Range.chardata_for_range += char_idx;
+                    job.Rects = range_rects + char_idx;
+                }
+                range_rects += range.num_chars;
+            }
+            tmp.Rects = NULL;
+        }
+
+        const int worker_count = ImMin(thread_count, jobs.Size) - 1;
+        std::atomic<int> next_job(0);
+        std::thread* workers = new std::thread[worker_count > 0 ? worker_count : 1];
+        for (int i = 0; i < worker_count; i++)
+            workers[i] = std::thread(RenderGlyphJobs, spc, jobs.Data, jobs.Size, &next_job, distance_field_spread);
+        RenderGlyphJobs(spc, jobs.Data, jobs.Size, &next_job, distance_field_spread);
+        for (int i = 0; i < worker_count; i++)
+            workers[i].join();
+        delete[] workers;
+    }
+    else
+#endif
     for (int input_i = 0; input_i < ConfigData.Size; input_i++)
     {
         ImFontConfig& cfg = ConfigData[input_i];
         ImFontTempBuildData& tmp = tmp_array[input_i];
         stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
-        stbtt_PackFontRangesRenderIntoRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
+        RenderGlyphsIntoRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects, distance_field_spread);
         tmp.Rects = NULL;
     }
 
@@ -1469,10 +1705,299 @@ bool    ImFontAtlas::Build()
 
     // Render into our custom data block
     RenderCustomTexData(1, &extra_rects);
+    TexDirtyRect = ImVec4(0.0f, 0.0f, (float)TexWidth, (float)TexHeight);
+
+    return true;
+}
+
+// Dynamic glyphs (DynamicGlyphs == true)
+// Build() only packs the custom data and sets up the font metrics. The packing context stays alive and each glyph is
+// rasterized into free atlas space the first time it is looked up, so startup time and atlas size follow the text actually displayed.
+// Glyphs of the ranges which aren't rasterized yet are flagged in ImFont::IndexLookup with their final advance in IndexXAdvance,
+// so text can be measured before it is first rendered.
+static const unsigned short GLYPH_INDEX_PENDING = (unsigned short)-2;   // (unsigned short)-1 is "no glyph"
+
+struct ImFontDynamicSource
+{
+    stbtt_fontinfo      FontInfo;
+    float               OffsetY;            // Baseline placement, same as the glyphs baked by Build()
+};
+
+struct ImFontAtlasDynamicData
+{
+    stbtt_pack_context              PackContext;
+    ImVector<ImFontDynamicSource>   Sources;    // One per ConfigData
+    bool                            PackFull;   // A glyph didn't fit, UpdateDynamicTexture() grows the texture
+};
+
+static void MarkTexDirty(ImFontAtlas* atlas, int x0, int y0, int x1, int y1)
+{
+    if (atlas->IsTexDirty())
+        atlas->TexDirtyRect = ImVec4(ImMin(atlas->TexDirtyRect.x, (float)x0), ImMin(atlas->TexDirtyRect.y, (float)y0), ImMax(atlas->TexDirtyRect.z, (float)x1), ImMax(atlas->TexDirtyRect.w, (float)y1));
+    else
+        atlas->TexDirtyRect = ImVec4((float)x0, (float)y0, (float)x1, (float)y1);
+
+    // Keep the RGBA32 copy in sync if the user asked for one
+    if (atlas->TexPixelsRGBA32)
+        for (int y = y0; y < y1; y++)
+            for (int x = x0; x < x1; x++)
+                atlas->TexPixelsRGBA32[y * atlas->TexWidth + x] = IM_COL32(255, 255, 255, (unsigned int)atlas->TexPixelsAlpha8[y * atlas->TexWidth + x]);
+}
+
+// First config of the font with 'codepoint' in its ranges, like the MergeMode rule of Build() (the first font providing a glyph wins)
+static int FindDynamicGlyphSource(const ImFontAtlas* atlas, const ImFont* font, int codepoint)
+{
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[input_i];
+        if (cfg.DstFont != font)
+            continue;
+        for (const ImWchar* in_range = cfg.GlyphRanges; in_range[0] && in_range[1]; in_range += 2)
+            if (codepoint >= in_range[0] && codepoint <= in_range[1])
+                return input_i;
+    }
+    return -1;
+}
+
+// Flag the glyphs of the font ranges which aren't rasterized yet. Called by ImFont::BuildLookupTable().
+static void MarkDynamicGlyphs(ImFontAtlas* atlas, ImFont* font)
+{
+    ImFontAtlasDynamicData* dyn = (ImFontAtlasDynamicData*)atlas->DynamicData;
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[input_i];
+        if (cfg.DstFont != font)
+            continue;
+        const stbtt_fontinfo& font_info = dyn->Sources[input_i].FontInfo;
+        const float font_scale = stbtt_ScaleForPixelHeight(&font_info, cfg.SizePixels);
+        for (const ImWchar* in_range = cfg.GlyphRanges; in_range[0] && in_range[1]; in_range += 2)
+        {
+            font->GrowIndex(in_range[1] + 1);
+            for (int codepoint = in_range[0]; codepoint <= in_range[1]; codepoint++)
+            {
+                if (font->IndexLookup[codepoint] != (unsigned short)-1) // Already rasterized, or provided by a previous config
+                    continue;
+                int advance, left_side_bearing;
+                stbtt_GetCodepointHMetrics(&font_info, codepoint, &advance, &left_side_bearing);
+                float x_advance = font_scale * advance + cfg.GlyphExtraSpacing.x; // Same as stbtt_packedchar::xadvance in Build()
+                if (cfg.PixelSnapH)
+                    x_advance = (float)(int)(x_advance + 0.5f);
+                font->IndexXAdvance[codepoint] = x_advance;
+                font->IndexLookup[codepoint] = GLYPH_INDEX_PENDING;
+            }
+        }
+    }
+}
+
+bool    ImFontAtlas::BuildDynamic()
+{
+    ImFontAtlasDynamicData* dyn = (ImFontAtlasDynamicData*)ImGui::MemAlloc(sizeof(ImFontAtlasDynamicData));
+    IM_PLACEMENT_NEW(dyn) ImFontAtlasDynamicData();
+    dyn->PackFull = false;
+    dyn->Sources.resize(ConfigData.Size);
+    for (int input_i = 0; input_i < ConfigData.Size; input_i++)
+    {
+        ImFontConfig& cfg = ConfigData[input_i];
+        IM_ASSERT(cfg.DstFont && (!cfg.DstFont->IsLoaded() || cfg.DstFont->ContainerAtlas == this));
+        const int font_offset = stbtt_GetFontOffsetForIndex((unsigned char*)cfg.FontData, cfg.FontNo);
+        IM_ASSERT(font_offset >= 0);
+        if (!stbtt_InitFont(&dyn->Sources[input_i].FontInfo, (unsigned char*)cfg.FontData, font_offset))
+        {
+            dyn->~ImFontAtlasDynamicData();
+            ImGui::MemFree(dyn);
+            return false;
+        }
+        dyn->Sources[input_i].FontInfo.userdata = NULL; // Allocation context, see STBTT_malloc
+        if (!cfg.GlyphRanges)
+            cfg.GlyphRanges = GetGlyphRangesDefault();
+    }
+
+    // Start small, UpdateDynamicTexture() doubles the height when glyphs stop fitting
+    TexWidth = (TexDesiredWidth > 0) ? TexDesiredWidth : 512;
+    const int max_tex_height = 1024*32;
+    stbtt_pack_context& spc = dyn->PackContext;
+    stbtt_PackBegin(&spc, NULL, TexWidth, max_tex_height, 0, 1, NULL);
+
+    ImVector<stbrp_rect> extra_rects;
+    RenderCustomTexData(0, &extra_rects);
+    stbrp_pack_rects((stbrp_context*)spc.pack_info, &extra_rects[0], extra_rects.Size);
+    TexHeight = TexWidth / 4;
+    for (int i = 0; i < extra_rects.Size; i++)
+        if (extra_rects[i].was_packed)
+            TexHeight = ImMax(TexHeight, extra_rects[i].y + extra_rects[i].h);
+    TexHeight = ImUpperPowerOfTwo(TexHeight);
+
+    TexPixelsAlpha8 = (unsigned char*)ImGui::MemAlloc(TexWidth * TexHeight);
+    memset(TexPixelsAlpha8, 0, TexWidth * TexHeight);
+    spc.pixels = TexPixelsAlpha8;
+    spc.height = TexHeight;
+    ((stbrp_context*)spc.pack_info)->height = TexHeight - spc.padding;
+    DynamicData = dyn;
+    RenderCustomTexData(1, &extra_rects);
 
+    // Setup ImFont for runtime, as in the third pass of Build() minus the glyphs
+    for (int input_i = 0; input_i < ConfigData.Size; input_i++)
+    {
+        ImFontConfig& cfg = ConfigData[input_i];
+        ImFontDynamicSource& src = dyn->Sources[input_i];
+        ImFont* dst_font = cfg.DstFont;
+
+        float font_scale = stbtt_ScaleForPixelHeight(&src.FontInfo, cfg.SizePixels);
+        int unscaled_ascent, unscaled_descent, unscaled_line_gap;
+        stbtt_GetFontVMetrics(&src.FontInfo, &unscaled_ascent, &unscaled_descent, &unscaled_line_gap);
+
+        float ascent = unscaled_ascent * font_scale;
+        float descent = unscaled_descent * font_scale;
+        if (!cfg.MergeMode)
+        {
+            dst_font->ContainerAtlas = this;
+            dst_font->ConfigData = &cfg;
+            dst_font->ConfigDataCount = 0;
+            dst_font->FontSize = cfg.SizePixels;
+            dst_font->Ascent = ascent;
+            dst_font->Descent = descent;
+            dst_font->Glyphs.resize(0);
+            dst_font->MetricsTotalSurface = 0;
+        }
+        dst_font->ConfigDataCount++;
+        float off_y = (cfg.MergeMode && cfg.MergeGlyphCenterV) ? (ascent - dst_font->Ascent) * 0.5f : 0.0f;
+        src.OffsetY = (float)(int)(dst_font->Ascent + off_y + 0.5f);
+        dst_font->FallbackGlyph = NULL;
+    }
+
+    // Once all the sources of a font are known: flag its glyphs (rasterizes the fallback and space glyphs)
+    for (int input_i = 0; input_i < ConfigData.Size; input_i++)
+        if (!ConfigData[input_i].MergeMode)
+            ConfigData[input_i].DstFont->BuildLookupTable();
+
+    TexDirtyRect = ImVec4(0.0f, 0.0f, (float)TexWidth, (float)TexHeight);
+    return true;
+}
+
+void    ImFontAtlas::ClearDynamicData()
+{
+    if (!DynamicData)
+        return;
+    ImFontAtlasDynamicData* dyn = (ImFontAtlasDynamicData*)DynamicData;
+    stbtt_PackEnd(&dyn->PackContext);
+    dyn->~ImFontAtlasDynamicData();
+    ImGui::MemFree(dyn);
+    DynamicData = NULL; // Glyphs still flagged as pending render as the fallback glyph
+}
+
+bool    ImFontAtlas::LoadDynamicGlyph(ImFont* font, ImWchar codepoint)
+{
+    ImFontAtlasDynamicData* dyn = (ImFontAtlasDynamicData*)DynamicData;
+    if (!dyn || dyn->PackFull)
+        return false;
+    const int input_i = FindDynamicGlyphSource(this, font, codepoint);
+    if (input_i < 0)
+        return false;
+    const ImFontConfig& cfg = ConfigData[input_i];
+    const ImFontDynamicSource& src = dyn->Sources[input_i];
+    stbtt_pack_context& spc = dyn->PackContext;
+
+    // Same packing and rendering as Build(), for a single character
+    stbtt_packedchar pc;
+    stbtt_pack_range range;
+    stbrp_rect rect;
+    memset(&pc, 0, sizeof(pc));
+    memset(&range, 0, sizeof(range));
+    memset(&rect, 0, sizeof(rect));
+    range.font_size = cfg.SizePixels;
+    range.first_unicode_codepoint_in_range = codepoint;
+    range.num_chars = 1;
+    range.chardata_for_range = &pc;
+    const int distance_field_spread = DistanceFieldGlyphs ? DistanceFieldSpread : 0;
+    if (distance_field_spread > 0)
+        stbtt_PackSetOversampling(&spc, 1, 1);
+    else
+        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+    stbtt_PackFontRangesGatherRects(&spc, &src.FontInfo, &range, 1, &rect);
+    if (distance_field_spread > 0)
+        GrowRectsForDistanceField(&rect, 1, distance_field_spread);
+    stbrp_pack_rects((stbrp_context*)spc.pack_info, &rect, 1);
+    if (!rect.was_packed)
+    {
+        dyn->PackFull = true;
+        return false;
+    }
+    RenderGlyphsIntoRects(&spc, &src.FontInfo, &range, 1, &rect, distance_field_spread);
+    MarkTexDirty(this, rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
+
+    stbtt_aligned_quad q;
+    float dummy_x = 0.0f, dummy_y = 0.0f;
+    stbtt_GetPackedQuad(&pc, TexWidth, TexHeight, 0, &dummy_x, &dummy_y, &q, 0);
+
+    // Appending may move the glyphs, FallbackGlyph points into them
+    IM_ASSERT(font->Glyphs.Size < 0xFFFE); // -1 and GLYPH_INDEX_PENDING are reserved
+    const int fallback_index = font->FallbackGlyph ? (int)(font->FallbackGlyph - font->Glyphs.Data) : -1;
+    font->Glyphs.resize(font->Glyphs.Size + 1);
+    ImFont::Glyph& glyph = font->Glyphs.back();
+    glyph.Codepoint = codepoint;
+    glyph.X0 = q.x0; glyph.Y0 = q.y0 + src.OffsetY; glyph.X1 = q.x1; glyph.Y1 = q.y1 + src.OffsetY;
+    glyph.U0 = q.s0; glyph.V0 = q.t0; glyph.U1 = q.s1; glyph.V1 = q.t1;
+    glyph.XAdvance = (pc.xadvance + cfg.GlyphExtraSpacing.x);
+    if (cfg.PixelSnapH)
+        glyph.XAdvance = (float)(int)(glyph.XAdvance + 0.5f);
+    font->MetricsTotalSurface += (int)((glyph.U1 - glyph.U0) * TexWidth + 1.99f) * (int)((glyph.V1 - glyph.V0) * TexHeight + 1.99f);
+    font->IndexXAdvance[codepoint] = glyph.XAdvance;
+    font->IndexLookup[codepoint] = (unsigned short)(font->Glyphs.Size - 1);
+    if (fallback_index >= 0)
+        font->FallbackGlyph = &font->Glyphs[fallback_index];
     return true;
 }
 
+void    ImFontAtlas::UpdateDynamicTexture()
+{
+    ImFontAtlasDynamicData* dyn = (ImFontAtlasDynamicData*)DynamicData;
+    if (!dyn || !dyn->PackFull)
+        return;
+    const int max_tex_height = 1024*16; // Largest texture of D3D11 class hardware
+    if (TexHeight * 2 > max_tex_height)
+        return; // Full for good, the remaining glyphs render as the fallback glyph
+
+    // Double the height. Width and rows are unchanged, so existing pixels and packed rectangles stay where they are.
+    const int old_height = TexHeight;
+    TexHeight *= 2;
+    unsigned char* pixels = (unsigned char*)ImGui::MemAlloc(TexWidth * TexHeight);
+    memcpy(pixels, TexPixelsAlpha8, TexWidth * old_height);
+    memset(pixels + TexWidth * old_height, 0, TexWidth * (TexHeight - old_height));
+    ImGui::MemFree(TexPixelsAlpha8);
+    TexPixelsAlpha8 = pixels;
+    if (TexPixelsRGBA32)
+    {
+        ImGui::MemFree(TexPixelsRGBA32); // Converted again by the next GetTexDataAsRGBA32()
+        TexPixelsRGBA32 = NULL;
+    }
+    stbtt_pack_context& spc = dyn->PackContext;
+    spc.pixels = TexPixelsAlpha8;
+    spc.height = TexHeight;
+    ((stbrp_context*)spc.pack_info)->height = TexHeight - spc.padding;
+    dyn->PackFull = false;
+
+    // Texture coordinates are normalized, rescale V of everything already in the atlas
+    const float v_scale = (float)old_height / TexHeight;
+    for (int i = 0; i < Fonts.Size; i++)
+    {
+        if (Fonts[i]->ContainerAtlas != this)
+            continue;
+        for (int glyph_n = 0; glyph_n < Fonts[i]->Glyphs.Size; glyph_n++)
+        {
+            Fonts[i]->Glyphs[glyph_n].V0 *= v_scale;
+            Fonts[i]->Glyphs[glyph_n].V1 *= v_scale;
+        }
+    }
+    TexUvWhitePixel.y *= v_scale;
+    for (int type = 0; type < ImGuiMouseCursor_Count_; type++)
+        for (int n = 0; n < 2; n++)
+        {
+            GImGui->MouseCursorData[type].TexUvMin[n].y *= v_scale;
+            GImGui->MouseCursorData[type].TexUvMax[n].y *= v_scale;
+        }
+    TexDirtyRect = ImVec4(0.0f, 0.0f, (float)TexWidth, (float)TexHeight);
+}
+
 void ImFontAtlas::RenderCustomTexData(int pass, void* p_rects)
 {
     // A work of art lies ahead! (. = white layer, X = black layer, others are blank)
@@ -1734,7 +2259,7 @@ void ImFont::BuildLookupTable()
     for (int i = 0; i != Glyphs.Size; i++)
         max_codepoint = ImMax(max_codepoint, (int)Glyphs[i].Codepoint);
 
-    IM_ASSERT(Glyphs.Size < 0xFFFF); // -1 is reserved
+    IM_ASSERT(Glyphs.Size < 0xFFFE); // -1 and -2 (glyph not rasterized yet, see ImFontAtlas::DynamicGlyphs) are reserved
     IndexXAdvance.clear();
     IndexLookup.clear();
     GrowIndex(max_codepoint + 1);
@@ -1744,25 +2269,30 @@ void ImFont::BuildLookupTable()
         IndexXAdvance[codepoint] = Glyphs[i].XAdvance;
         IndexLookup[codepoint] = (unsigned short)i;
     }
+    if (ContainerAtlas && ContainerAtlas->DynamicData)
+        MarkDynamicGlyphs(ContainerAtlas, this);
 
     // Create a glyph to handle TAB
     // FIXME: Needs proper TAB handling but it needs to be contextualized (or we could arbitrary say that each string starts at "column 0" ?)
     if (FindGlyph((unsigned short)' '))
     {
-        if (Glyphs.back().Codepoint != '\t')   // So we can call this function multiple times
+        int tab_index = 0;
+        while (tab_index < Glyphs.Size && Glyphs[tab_index].Codepoint != '\t') // So we can call this function multiple times (dynamic glyphs may follow it)
+            tab_index++;
+        if (tab_index == Glyphs.Size)
             Glyphs.resize(Glyphs.Size + 1);
-        ImFont::Glyph& tab_glyph = Glyphs.back();
+        ImFont::Glyph& tab_glyph = Glyphs[tab_index];
         tab_glyph = *FindGlyph((unsigned short)' ');
         tab_glyph.Codepoint = '\t';
         tab_glyph.XAdvance *= 4;
         IndexXAdvance[(int)tab_glyph.Codepoint] = (float)tab_glyph.XAdvance;
-        IndexLookup[(int)tab_glyph.Codepoint] = (unsigned short)(Glyphs.Size-1);
+        IndexLookup[(int)tab_glyph.Codepoint] = (unsigned short)tab_index;
     }
 
     FallbackGlyph = NULL;
     FallbackGlyph = FindGlyph(FallbackChar);
     FallbackXAdvance = FallbackGlyph ? FallbackGlyph->XAdvance : 0.0f;
-    for (int i = 0; i < max_codepoint + 1; i++)
+    for (int i = 0; i < IndexXAdvance.Size; i++)
         if (IndexXAdvance[i] < 0.0f)
             IndexXAdvance[i] = FallbackXAdvance;
 }
@@ -1808,8 +2338,10 @@ const ImFont::Glyph* ImFont::FindGlyph(unsigned short c) const
     if (c < IndexLookup.Size)
     {
         const unsigned short i = IndexLookup[c];
-        if (i != (unsigned short)-1)
+        if (i < GLYPH_INDEX_PENDING)
             return &Glyphs.Data[i];
+        if (i == GLYPH_INDEX_PENDING && ContainerAtlas->LoadDynamicGlyph(const_cast<ImFont*>(this), c))
+            return &Glyphs.Data[IndexLookup[c]];
     }
     return FallbackGlyph;
 }
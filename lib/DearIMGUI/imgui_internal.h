@@ -375,6 +375,7 @@ struct ImGuiContext
     int                     FrameCountEnded;
     int                     FrameCountRendered;
     ImVector<ImGuiWindow*>  Windows;
+    ImGuiStorage            WindowsById;                        // ImGuiWindow::ID -> ImGuiWindow*, for FindWindowByName()
     ImVector<ImGuiWindow*>  WindowsSortBuffer;
     ImGuiWindow*            CurrentWindow;                      // Being drawn into
     ImVector<ImGuiWindow*>  CurrentWindowStack;
@@ -394,6 +395,7 @@ struct ImGuiContext
     ImGuiWindow*            MovedWindow;                        // Track the child window we clicked on to move a window.
     ImGuiID                 MovedWindowMoveId;                  // == MovedWindow->RootWindow->MoveId
     ImVector<ImGuiIniData>  Settings;                           // .ini Settings
+    ImGuiStorage            SettingsById;                       // ImGuiIniData::Id -> index in Settings + 1, for FindWindowSettings()
     float                   SettingsDirtyTimer;                 // Save .ini Settings on disk when time reaches zero
     ImVector<ImGuiColMod>   ColorModifiers;                     // Stack for PushStyleColor()/PopStyleColor()
     ImVector<ImGuiStyleMod> StyleModifiers;                     // Stack for PushStyleVar()/PopStyleVar()
@@ -614,6 +616,19 @@ struct IMGUI_API ImGuiDrawContext
     }
 };
 
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+// Cost of a window over one frame (IMGUI_ENABLE_WINDOW_METRICS)
+struct ImGuiWindowMetrics
+{
+    float       Time;               // Seconds between Begin() and End(), excluding child windows; all Begin()/End() pairs of the frame
+    int         ItemCount;          // ItemAdd() calls, clipped items included
+    int         VtxCount;           // Output of the window's draw list
+    int         CmdCount;
+
+    ImGuiWindowMetrics()            { Time = 0.0f; ItemCount = VtxCount = CmdCount = 0; }
+};
+#endif
+
 // Windows data
 struct IMGUI_API ImGuiWindow
 {
@@ -674,6 +689,12 @@ struct IMGUI_API ImGuiWindow
     int                     FocusIdxAllRequestNext;             // Item being requested for focus, for next update (relies on layout to be stable between the frame pressing TAB and the next frame)
     int                     FocusIdxTabRequestNext;             // "
 
+#ifdef IMGUI_ENABLE_WINDOW_METRICS
+    ImGuiWindowMetrics      Metrics;                            // Last completed frame
+    ImGuiWindowMetrics      MetricsCurrent;                     // Frame in progress, moved to Metrics by NewFrame()
+    double                  MetricsSegmentStart;                // Time this window last became the current window
+#endif
+
 public:
     ImGuiWindow(const char* name);
     ~ImGuiWindow();
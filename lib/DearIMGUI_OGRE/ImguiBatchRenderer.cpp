@@ -0,0 +1,420 @@
+#include "ImguiBatchRenderer.h"
+
+#include <chrono>
+#include <string.h> // memcpy, memset
+
+// Number of frames worth of geometry the ring buffers hold before wrapping around
+static const int RingFrameCount = 3;
+
+// Buffer sizes to start with
+static const int InitialVertexBufferSize = 5000;
+static const int InitialIndexBufferSize = 10000;
+
+// Most uploads of a draw list that keeps changing behind its SampleKey() before it is hashed again,
+// and most keys remembered as changing
+static const int MaxHashBackoff = 16;
+static const int MaxHashBackoffKeys = 1024;
+
+// Seconds, for the stage timings of RenderStats
+static double GetTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 64-bit hash of a block of geometry, optionally copying it to `copyTo` on the way so that uploads read their
+// source only once. Four independent lanes over 8 byte words keep the multiplies from serializing.
+static inline unsigned long long MixWord(unsigned long long h, unsigned long long word)
+{
+    h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+    return (h << 29) | (h >> 35); // Without the rotation, high bit changes in two words could cancel out
+}
+
+static unsigned long long HashGeometry(const void* data, size_t size, unsigned long long seed, void* copyTo)
+{
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    unsigned char* dst = static_cast<unsigned char*>(copyTo);
+    unsigned long long h0 = seed;
+    unsigned long long h1 = seed + 0x9E3779B97F4A7C15ull;
+    unsigned long long h2 = seed + 0xC2B2AE3D27D4EB4Full;
+    unsigned long long h3 = seed + size;
+    size_t pos = 0;
+    for (; pos + 32 <= size; pos += 32)
+    {
+        unsigned long long words[4];
+        memcpy(words, src + pos, 32);
+        if (dst)
+        {
+            memcpy(dst + pos, words, 32);
+        }
+        h0 = MixWord(h0, words[0]);
+        h1 = MixWord(h1, words[1]);
+        h2 = MixWord(h2, words[2]);
+        h3 = MixWord(h3, words[3]);
+    }
+
+    unsigned long long h = MixWord(MixWord(MixWord(h0, h1), h2), h3);
+    for (; pos < size; pos += 8) // Tail of less than 32 bytes
+    {
+        const size_t count = (size - pos < 8) ? size - pos : 8;
+        unsigned long long word = 0;
+        memcpy(&word, src + pos, count);
+        if (dst)
+        {
+            memcpy(dst + pos, src + pos, count);
+        }
+        h = MixWord(h, word);
+    }
+    h ^= h >> 32;
+    h *= 0xC2B2AE3D27D4EB4Full;
+    return h ^ (h >> 29);
+}
+
+static unsigned long long HashDrawList(const ImDrawList* drawList, ImDrawVert* vtxDst, ImDrawIdx* idxDst)
+{
+    const unsigned long long h = HashGeometry(drawList->VtxBuffer.Data, drawList->VtxBuffer.Size * sizeof(ImDrawVert), 0, vtxDst);
+    return HashGeometry(drawList->IdxBuffer.Data, drawList->IdxBuffer.Size * sizeof(ImDrawIdx), h, idxDst);
+}
+
+static ImGuiID FoldKey(unsigned long long key)
+{
+    return static_cast<ImGuiID>(key ^ (key >> 32));
+}
+
+// Cheap fingerprint of a draw list: its sizes and both ends of its vertices. Lists with different keys
+// differ for sure, so only lists matching a cached one by key are hashed in full before deciding.
+static unsigned long long SampleKey(const ImDrawList* drawList)
+{
+    const size_t vtxBytes = drawList->VtxBuffer.Size * sizeof(ImDrawVert);
+    const size_t sampleBytes = (vtxBytes < 32) ? vtxBytes : 32;
+    const unsigned char* vtx = reinterpret_cast<const unsigned char*>(drawList->VtxBuffer.Data);
+    unsigned long long key = MixWord(drawList->VtxBuffer.Size, drawList->IdxBuffer.Size);
+    key = HashGeometry(vtx, sampleBytes, key, NULL);
+    return HashGeometry(vtx + vtxBytes - sampleBytes, sampleBytes, key, NULL);
+}
+
+// Grows a buffer capacity geometrically, so that small frame-to-frame fluctuations
+// of the UI geometry don't cause the hardware buffers to be re-created.
+static int GrowBufferSize(int capacity, unsigned int needed)
+{
+    while (capacity < static_cast<int>(needed))
+    {
+        capacity += capacity / 2;
+    }
+    return capacity;
+}
+
+ImguiBatchRenderer::ImguiBatchRenderer()
+    :mDevice(0)
+    ,mRenderMode(RM_MERGED_FRAME)
+    ,mVertexBufferSize(0)
+    ,mIndexBufferSize(0)
+    ,mVertexWritePos(0)
+    ,mIndexWritePos(0)
+{
+    memset(&mRenderStats, 0, sizeof(mRenderStats));
+}
+
+void ImguiBatchRenderer::setDevice(ImguiRenderDevice* device)
+{
+    mDevice = device;
+    mVertexBufferSize = 0;
+    mIndexBufferSize = 0;
+    this->clearListCache();
+}
+
+void ImguiBatchRenderer::render(const ImDrawData* drawData, int vpWidth, int vpHeight)
+{
+    memset(&mRenderStats, 0, sizeof(mRenderStats));
+
+    if (drawData->TotalIdxCount == 0)
+    {
+        return; // Nothing to draw
+    }
+
+    const double startTime = GetTime();
+    this->reserveBuffers(drawData->TotalVtxCount, drawData->TotalIdxCount);
+    this->uploadLists(drawData);
+
+    const double submitStartTime = GetTime();
+
+    // Apply the full render state once; the draws below only change what actually differs
+    mDevice->beginRender();
+    ++mRenderStats.passApplications;
+
+    bool textureBound = false;
+    ImTextureID boundTexId = 0;
+    int boundScissor[4] = { -1, -1, -1, -1 };
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+    {
+        const ImDrawList* draw_list = drawData->CmdLists[i];
+        const unsigned int listVtxStart = mListRegions[i].vtxStart;
+
+        // Commands draw sub-ranges of the list's geometry
+        unsigned int idxStart = mListRegions[i].idxStart;
+        for (int j = 0; j < draw_list->CmdBuffer.Size; ++j)
+        {
+            const ImDrawCmd* drawCmd = &draw_list->CmdBuffer[j];
+            if (drawCmd->UserCallback)
+            {
+                continue; // The backend doesn't execute callbacks
+            }
+
+            int scLeft   = static_cast<int>(drawCmd->ClipRect.x); // Obtain bounds
+            int scTop    = static_cast<int>(drawCmd->ClipRect.y);
+            int scRight  = static_cast<int>(drawCmd->ClipRect.z);
+            int scBottom = static_cast<int>(drawCmd->ClipRect.w);
+
+            scLeft   = scLeft   < 0 ? 0 : (scLeft  > vpWidth ? vpWidth : scLeft); // Clamp bounds to viewport dimensions
+            scRight  = scRight  < 0 ? 0 : (scRight > vpWidth ? vpWidth : scRight);
+            scTop    = scTop    < 0 ? 0 : (scTop    > vpHeight ? vpHeight : scTop);
+            scBottom = scBottom < 0 ? 0 : (scBottom > vpHeight ? vpHeight : scBottom);
+
+            // Set scissoring
+            if (scLeft != boundScissor[0] || scTop != boundScissor[1] || scRight != boundScissor[2] || scBottom != boundScissor[3])
+            {
+                boundScissor[0] = scLeft;
+                boundScissor[1] = scTop;
+                boundScissor[2] = scRight;
+                boundScissor[3] = scBottom;
+                mDevice->setScissor(scLeft, scTop, scRight, scBottom);
+                ++mRenderStats.scissorChanges;
+            }
+
+            // Select texture
+            if (!textureBound || drawCmd->TextureId != boundTexId)
+            {
+                textureBound = true;
+                boundTexId = drawCmd->TextureId;
+                mDevice->setTexture(boundTexId);
+                ++mRenderStats.textureSwitches;
+            }
+
+            // Render!
+            mDevice->drawIndexed(listVtxStart, draw_list->VtxBuffer.Size, idxStart, drawCmd->ElemCount);
+            ++mRenderStats.drawCalls;
+
+            idxStart += drawCmd->ElemCount;
+        }
+    }
+    mDevice->endRender();
+    mRenderStats.uploadTime = submitStartTime - startTime;
+    mRenderStats.submitTime = GetTime() - submitStartTime;
+}
+
+// Uploads the draw lists whose geometry isn't in the buffers yet; the others are drawn from where they already are,
+// so a frame where only an overlay changes only uploads the overlay. RM_MERGED_FRAME packs the uploads into a
+// single lock/unlock, RM_PER_DRAW_LIST locks once per uploaded list.
+// Indices are left relative to their list; the list's position is passed as base vertex when drawing.
+void ImguiBatchRenderer::uploadLists(const ImDrawData* drawData)
+{
+    mListRegions.resize(drawData->CmdListsCount);
+    unsigned int uploadVtxCount = 0;
+    unsigned int uploadIdxCount = 0;
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+    {
+        const ImDrawList* draw_list = drawData->CmdLists[i];
+        ListRegion& region = mListRegions[i];
+        region.vtxStart = 0;
+        region.idxStart = 0;
+        region.upload = false;
+        region.hashed = false;
+        region.hashOnCopy = false;
+        if (draw_list->VtxBuffer.Size == 0 || draw_list->IdxBuffer.Size == 0)
+        {
+            continue; // Nothing to draw
+        }
+
+        // Hashing costs about as much as the upload it saves, so it is only paid for lists likely to be unchanged.
+        // A list whose key is new is being rewritten (a plot, a scrolled list): it is uploaded without the full
+        // hash, and only hashed once its key repeats.
+        region.key = SampleKey(draw_list);
+        const CachedList* cached = this->findCachedList(region.key, draw_list->VtxBuffer.Size, draw_list->IdxBuffer.Size);
+        const int backoff = cached ? mHashBackoff.GetInt(FoldKey(region.key)) : 0;
+        if (cached && (backoff & 0xFF) > 0)
+        {
+            mHashBackoff.SetInt(FoldKey(region.key), backoff - 1);
+        }
+        else if (cached && !cached->hashed)
+        {
+            region.hashOnCopy = true;
+        }
+        else if (cached)
+        {
+            region.hash = HashDrawList(draw_list, NULL, NULL);
+            region.hashed = true;
+            if (region.hash == cached->hash)
+            {
+                if (backoff != 0)
+                {
+                    mHashBackoff.SetInt(FoldKey(region.key), 0);
+                }
+                region.vtxStart = cached->vtxStart;
+                region.idxStart = cached->idxStart;
+                ++mRenderStats.uploadsSkipped;
+                continue;
+            }
+
+            // Same key but new content, e.g. a counter whose last digit doesn't change: the list keeps changing
+            // behind its key, so skip hashing it for longer and longer
+            const int delay = (backoff >> 8) ? (backoff >> 8) : 1;
+            const int nextDelay = (delay * 2 < MaxHashBackoff) ? delay * 2 : MaxHashBackoff;
+            mHashBackoff.SetInt(FoldKey(region.key), (nextDelay << 8) | delay);
+        }
+        region.upload = true;
+        uploadVtxCount += draw_list->VtxBuffer.Size;
+        uploadIdxCount += draw_list->IdxBuffer.Size;
+    }
+
+    if (uploadVtxCount == 0)
+    {
+        return;
+    }
+
+    if (mVertexWritePos + static_cast<int>(uploadVtxCount) > mVertexBufferSize || mIndexWritePos + static_cast<int>(uploadIdxCount) > mIndexBufferSize)
+    {
+        // The uploads would wrap the rings around, and the discard would drop the lists planned to be drawn from
+        // the buffers: upload the whole frame behind the discard instead
+        this->clearListCache();
+        mVertexWritePos = mVertexBufferSize; // Forces the discard in lockRegion()
+        uploadVtxCount = 0;
+        uploadIdxCount = 0;
+        for (int i = 0; i < drawData->CmdListsCount; ++i)
+        {
+            const ImDrawList* draw_list = drawData->CmdLists[i];
+            if (draw_list->VtxBuffer.Size > 0 && draw_list->IdxBuffer.Size > 0)
+            {
+                mListRegions[i].upload = true;
+                uploadVtxCount += draw_list->VtxBuffer.Size;
+                uploadIdxCount += draw_list->IdxBuffer.Size;
+            }
+        }
+        mRenderStats.uploadsSkipped = 0;
+    }
+
+    BufferRegion merged;
+    memset(&merged, 0, sizeof(merged));
+    if (mRenderMode == RM_MERGED_FRAME)
+    {
+        merged = this->lockRegion(uploadVtxCount, uploadIdxCount);
+    }
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+    {
+        ListRegion& region = mListRegions[i];
+        if (!region.upload)
+        {
+            continue;
+        }
+
+        const ImDrawList* draw_list = drawData->CmdLists[i];
+        const BufferRegion dst = (mRenderMode == RM_MERGED_FRAME) ? merged : this->lockRegion(draw_list->VtxBuffer.Size, draw_list->IdxBuffer.Size);
+        if (region.hashOnCopy)
+        {
+            region.hash = HashDrawList(draw_list, dst.vtxDst, dst.idxDst); // Copies while hashing, the list is read once
+            region.hashed = true;
+        }
+        else
+        {
+            memcpy(dst.vtxDst, draw_list->VtxBuffer.Data, draw_list->VtxBuffer.Size * sizeof(ImDrawVert));
+            memcpy(dst.idxDst, draw_list->IdxBuffer.Data, draw_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+        }
+        if (mRenderMode == RM_MERGED_FRAME)
+        {
+            merged.vtxDst += draw_list->VtxBuffer.Size;
+            merged.idxDst += draw_list->IdxBuffer.Size;
+            merged.vtxStart += draw_list->VtxBuffer.Size;
+            merged.idxStart += draw_list->IdxBuffer.Size;
+        }
+        else
+        {
+            mDevice->unlockBuffers();
+        }
+        mRenderStats.bytesUploaded += draw_list->VtxBuffer.Size * sizeof(ImDrawVert) + draw_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+        region.vtxStart = dst.vtxStart;
+        region.idxStart = dst.idxStart;
+
+        CachedList cached;
+        cached.key = region.key;
+        cached.hash = region.hash;
+        cached.hashed = region.hashed;
+        cached.vtxCount = draw_list->VtxBuffer.Size;
+        cached.idxCount = draw_list->IdxBuffer.Size;
+        cached.vtxStart = region.vtxStart;
+        cached.idxStart = region.idxStart;
+        mListCache.push_back(cached);
+        mListCacheIndex.SetInt(FoldKey(cached.key), mListCache.Size);
+    }
+    if (mRenderMode == RM_MERGED_FRAME)
+    {
+        mDevice->unlockBuffers();
+    }
+}
+
+// Latest upload with the given SampleKey(); its hash, when computed, tells whether it really holds the same geometry
+const ImguiBatchRenderer::CachedList* ImguiBatchRenderer::findCachedList(unsigned long long key, unsigned int vtxCount, unsigned int idxCount) const
+{
+    const int index = mListCacheIndex.GetInt(FoldKey(key)) - 1;
+    if (index < 0)
+    {
+        return NULL;
+    }
+    const CachedList& cached = mListCache[index];
+    return (cached.key == key && cached.vtxCount == vtxCount && cached.idxCount == idxCount) ? &cached : NULL;
+}
+
+void ImguiBatchRenderer::clearListCache()
+{
+    mListCache.resize(0);
+    mListCacheIndex.Clear();
+    if (mHashBackoff.GetCount() > MaxHashBackoffKeys) // Outlives the cache, but not forever
+    {
+        mHashBackoff.Clear();
+    }
+}
+
+// Buffers are only ever grown; once the UI reaches its working size, they are reused every frame.
+// They hold RingFrameCount whole frames, so the uploads of a frame never need to wrap around more than once.
+void ImguiBatchRenderer::reserveBuffers(unsigned int vtxCount, unsigned int idxCount)
+{
+    if (mVertexBufferSize < static_cast<int>(vtxCount * RingFrameCount))
+    {
+        mVertexBufferSize = GrowBufferSize((mVertexBufferSize > 0) ? mVertexBufferSize : InitialVertexBufferSize, vtxCount * RingFrameCount);
+        mDevice->createVertexBuffer(mVertexBufferSize);
+        mVertexWritePos = mVertexBufferSize; // Forces a discard on the next lock
+        ++mRenderStats.bufferCreations;
+        this->clearListCache();
+    }
+    if (mIndexBufferSize < static_cast<int>(idxCount * RingFrameCount))
+    {
+        mIndexBufferSize = GrowBufferSize((mIndexBufferSize > 0) ? mIndexBufferSize : InitialIndexBufferSize, idxCount * RingFrameCount);
+        mDevice->createIndexBuffer(mIndexBufferSize);
+        mIndexWritePos = mIndexBufferSize;
+        ++mRenderStats.bufferCreations;
+        this->clearListCache();
+    }
+}
+
+// The buffers are used as rings: each upload is appended behind the previous one with HBL_NO_OVERWRITE,
+// which promises the driver not to touch data the GPU may still be reading, so it never has to stall or
+// rename the buffer. Only when the ring is full it wraps around with a single HBL_DISCARD.
+ImguiBatchRenderer::BufferRegion ImguiBatchRenderer::lockRegion(unsigned int vtxCount, unsigned int idxCount)
+{
+    // Both rings wrap together, so a discard never invalidates data the other one still refers to
+    bool discard = false;
+    if (mVertexWritePos + static_cast<int>(vtxCount) > mVertexBufferSize || mIndexWritePos + static_cast<int>(idxCount) > mIndexBufferSize)
+    {
+        mVertexWritePos = 0;
+        mIndexWritePos = 0;
+        discard = true;
+        ++mRenderStats.bufferDiscards;
+    }
+
+    BufferRegion region;
+    region.vtxStart = mVertexWritePos;
+    region.idxStart = mIndexWritePos;
+    mDevice->lockBuffers(region.vtxStart, vtxCount, region.idxStart, idxCount, discard, &region.vtxDst, &region.idxDst);
+    mRenderStats.bufferLocks += 2;
+    mVertexWritePos += vtxCount;
+    mIndexWritePos += idxCount;
+
+    return region;
+}
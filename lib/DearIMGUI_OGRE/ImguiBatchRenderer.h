@@ -0,0 +1,122 @@
+#pragma once
+
+#include <imgui.h>
+
+/// Render system operations needed to draw ImDrawData.
+/// Implemented by the OGRE back-end (see ImguiManager.h); headless builds can substitute their own.
+class ImguiRenderDevice
+{
+public:
+    virtual ~ImguiRenderDevice() {}
+
+    /// (Re)creates the dynamic vertex/index buffer; previous contents are dropped
+    virtual void createVertexBuffer(unsigned int numVertices) = 0;
+    virtual void createIndexBuffer(unsigned int numIndices) = 0;
+    /// Locks the given ranges for writing, pair with unlockBuffers().
+    /// @param discard True: the whole buffers may be thrown away (HBL_DISCARD).
+    ///                False: the ranges are guaranteed not to be in use by the GPU (HBL_NO_OVERWRITE).
+    virtual void lockBuffers(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount,
+                             bool discard, ImDrawVert** vtxDst, ImDrawIdx** idxDst) = 0;
+    virtual void unlockBuffers() = 0;
+
+    /// Applies the full render state (blending, depth, programs...) before the draws of a frame
+    virtual void beginRender() = 0;
+    virtual void setScissor(int left, int top, int right, int bottom) = 0;
+    virtual void setTexture(ImTextureID texId) = 0;
+    /// Draws indices relative to `vtxStart`, which acts as base vertex
+    virtual void drawIndexed(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount) = 0;
+    virtual void endRender() = 0;
+};
+
+/// Streams ImDrawData to an ImguiRenderDevice: ring-buffered uploads, skipping of unchanged
+/// geometry and elimination of redundant state changes.
+/// Holds no render system specifics, so it can be driven and measured without a GPU.
+class ImguiBatchRenderer
+{
+public:
+    /// How render() streams the ImDrawData geometry to the GPU
+    enum RenderMode
+    {
+        RM_PER_DRAW_LIST, ///< One lock/upload per ImDrawList
+        RM_MERGED_FRAME   ///< All ImDrawLists packed into one vertex + one index stream, locked once per frame
+    };
+
+    /// Counters collected by render(); reset at the start of every frame
+    struct RenderStats
+    {
+        unsigned int bufferCreations;   ///< Hardware vertex/index buffers (re)created this frame; 0 in steady state
+        unsigned int bufferLocks;       ///< Hardware buffer lock/unlock round trips this frame
+        unsigned int bufferDiscards;    ///< Ring buffer wrap-arounds, the only locks using HBL_DISCARD
+        unsigned int uploadsSkipped;    ///< Draw lists not uploaded because their unchanged geometry was still in the buffers
+        size_t       bytesUploaded;     ///< Vertex + index bytes copied to hardware buffers this frame
+        unsigned int textureSwitches;   ///< Changes of the bound texture between consecutive draws this frame
+        unsigned int drawCalls;         ///< Draws submitted this frame
+        unsigned int passApplications;  ///< Full render state applications (blending, depth, programs, textures) this frame
+        unsigned int scissorChanges;    ///< Scissor rects actually sent to the render system this frame
+        double       uploadTime;        ///< Seconds spent locking, copying and unlocking buffers this frame
+        double       submitTime;        ///< Seconds spent setting state and issuing draws this frame
+    };
+
+    ImguiBatchRenderer();
+
+    /// Sets the device to draw with; buffers are re-created on the next render(). Pass NULL before destroying the device.
+    void setDevice(ImguiRenderDevice* device);
+    void render(const ImDrawData* drawData, int vpWidth, int vpHeight);
+
+    const RenderStats& getRenderStats() const { return mRenderStats; }
+    void setRenderMode(RenderMode mode) { mRenderMode = mode; }
+    RenderMode getRenderMode() const { return mRenderMode; }
+
+private:
+    /// Space reserved in the ring buffers by lockRegion()
+    struct BufferRegion
+    {
+        ImDrawVert*  vtxDst;     ///< Write pointers, valid until ImguiRenderDevice::unlockBuffers()
+        ImDrawIdx*   idxDst;
+        unsigned int vtxStart;   ///< Position of the region within the buffers
+        unsigned int idxStart;
+    };
+
+    /// Where a draw list of the frame being rendered is drawn from
+    struct ListRegion
+    {
+        unsigned long long key;        ///< Cheap fingerprint, finds the cached upload to compare with
+        unsigned long long hash;       ///< Of all the list's vertices and indices
+        unsigned int       vtxStart;
+        unsigned int       idxStart;
+        bool               upload;     ///< Not in the buffers yet; uploadLists() copies it and sets the start positions
+        bool               hashed;     ///< `hash` is computed
+        bool               hashOnCopy; ///< Compute `hash` while copying the list: its key matched an upload that wasn't hashed
+    };
+
+    /// Geometry uploaded since the ring buffers last wrapped around. Appends never overwrite it, so a
+    /// draw list hashing to the same geometry is drawn from there instead of being uploaded again.
+    struct CachedList
+    {
+        unsigned long long key;
+        unsigned long long hash;
+        unsigned int       vtxCount;
+        unsigned int       idxCount;
+        unsigned int       vtxStart;
+        unsigned int       idxStart;
+        bool               hashed;   ///< False when uploaded without computing `hash`, see uploadLists()
+    };
+
+    void reserveBuffers(unsigned int vtxCount, unsigned int idxCount);
+    BufferRegion lockRegion(unsigned int vtxCount, unsigned int idxCount);
+    void uploadLists(const ImDrawData* drawData);
+    const CachedList* findCachedList(unsigned long long key, unsigned int vtxCount, unsigned int idxCount) const;
+    void clearListCache();
+
+    ImguiRenderDevice*   mDevice;
+    RenderMode           mRenderMode;
+    RenderStats          mRenderStats;
+    int                  mVertexBufferSize; ///< Capacity of the vertex buffer, in vertices; 0 = not created yet
+    int                  mIndexBufferSize;  ///< Capacity of the index buffer, in indices
+    int                  mVertexWritePos;   ///< Ring position where the next vertex upload is appended
+    int                  mIndexWritePos;
+    ImVector<ListRegion> mListRegions;      ///< One per draw list of the frame being rendered
+    ImVector<CachedList> mListCache;        ///< Emptied whenever the buffers are discarded or re-created
+    ImGuiStorage         mListCacheIndex;   ///< Folded CachedList::key -> index in mListCache + 1
+    ImGuiStorage         mHashBackoff;      ///< Folded key of a list changing behind it -> next delay << 8 | uploads left unhashed
+};
@@ -0,0 +1,224 @@
+#if defined(_MSC_VER) && !defined(_CRT_SECURE_NO_WARNINGS)
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "ImguiFontCache.h"
+
+#include <imgui_internal.h> // ImHash, GImGui->MouseCursorData
+
+#include <stdio.h>
+#include <string.h>
+
+// File layout, native endianness (the cache is local to the machine):
+//   CacheHeader
+//   per font:    FontHeader, ImFont::Glyph[glyphCount]
+//   ImGuiMouseCursorData[ImGuiMouseCursor_Count_]   (texture coordinates of the cursor shapes baked into the atlas)
+//   alpha8 pixels, texWidth * texHeight bytes
+
+static const char         CacheMagic[4] = { 'I', 'M', 'F', 'A' };
+static const unsigned int CacheVersion  = 1;
+
+// Largest atlas side accepted from a cache file; anything bigger is a corrupt header, not an atlas
+static const int          MaxTexSize    = 16384;
+
+struct CacheHeader
+{
+    char         magic[4];
+    unsigned int version;
+    ImU32        inputHash;
+    int          texWidth;
+    int          texHeight;
+    ImVec2       texUvWhitePixel;
+    int          fontCount;
+};
+
+struct FontHeader
+{
+    float FontSize;
+    float Ascent;
+    float Descent;
+    int   MetricsTotalSurface;
+    int   ConfigDataCount;
+    int   GlyphCount;
+};
+
+// Hash of everything ImFontAtlas::Build() depends on
+static ImU32 HashAtlasInputs(const ImFontAtlas* atlas)
+{
+    // ImHash() treats size 0 as a zero terminated string, so every field is hashed with an explicit size
+    const int layout[] = { static_cast<int>(CacheVersion), static_cast<int>(sizeof(ImFont::Glyph)), static_cast<int>(sizeof(ImWchar)),
+                           atlas->TexDesiredWidth, atlas->DistanceFieldGlyphs ? atlas->DistanceFieldSpread : 0,
+                           atlas->ConfigData.Size, atlas->Fonts.Size };
+    ImU32 hash = ImHash(layout, sizeof(layout));
+
+    for (int i = 0; i < atlas->ConfigData.Size; ++i)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[i];
+        if (cfg.FontData == NULL || cfg.FontDataSize <= 0)
+        {
+            return 0;
+        }
+        hash = ImHash(cfg.FontData, cfg.FontDataSize, hash);
+
+        int dstFont = 0;
+        while (dstFont < atlas->Fonts.Size && atlas->Fonts[dstFont] != cfg.DstFont)
+        {
+            ++dstFont;
+        }
+        const int intParams[] = { cfg.FontDataSize, cfg.FontNo, cfg.OversampleH, cfg.OversampleV,
+                                  cfg.PixelSnapH ? 1 : 0, cfg.MergeMode ? 1 : 0, cfg.MergeGlyphCenterV ? 1 : 0, dstFont };
+        const float floatParams[] = { cfg.SizePixels, cfg.GlyphExtraSpacing.x, cfg.GlyphExtraSpacing.y };
+        hash = ImHash(intParams, sizeof(intParams), hash);
+        hash = ImHash(floatParams, sizeof(floatParams), hash);
+
+        const ImWchar* ranges = cfg.GlyphRanges ? cfg.GlyphRanges : const_cast<ImFontAtlas*>(atlas)->GetGlyphRangesDefault();
+        int rangesSize = 0;
+        while (ranges[rangesSize] && ranges[rangesSize + 1])
+        {
+            rangesSize += 2;
+        }
+        if (rangesSize > 0)
+        {
+            hash = ImHash(ranges, rangesSize * static_cast<int>(sizeof(ImWchar)), hash);
+        }
+    }
+    return hash;
+}
+
+bool ImguiFontCache::LoadAtlas(ImFontAtlas* atlas, const char* path)
+{
+    IM_ASSERT(atlas->TexPixelsAlpha8 == NULL); // Already built
+    if (atlas->ConfigData.Size == 0 || atlas->DynamicGlyphs)
+    {
+        return false;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0
+        || header.version != CacheVersion || header.inputHash != HashAtlasInputs(atlas) || header.fontCount != atlas->Fonts.Size
+        || header.texWidth <= 0 || header.texWidth > MaxTexSize || header.texHeight <= 0 || header.texHeight > MaxTexSize)
+    {
+        fclose(file);
+        return false;
+    }
+
+    bool ok = true;
+    for (int i = 0; ok && i < atlas->Fonts.Size; ++i)
+    {
+        ImFont* font = atlas->Fonts[i];
+        FontHeader fontHeader;
+        ok = fread(&fontHeader, sizeof(fontHeader), 1, file) == 1 && fontHeader.GlyphCount >= 0;
+        if (ok)
+        {
+            font->Glyphs.resize(fontHeader.GlyphCount);
+            ok = fontHeader.GlyphCount == 0 || fread(font->Glyphs.Data, sizeof(ImFont::Glyph), fontHeader.GlyphCount, file) == static_cast<size_t>(fontHeader.GlyphCount);
+        }
+        if (ok)
+        {
+            // Same as the runtime setup at the end of ImFontAtlas::Build()
+            font->ContainerAtlas = atlas;
+            font->ConfigData = NULL;
+            for (int c = 0; c < atlas->ConfigData.Size && font->ConfigData == NULL; ++c)
+            {
+                if (atlas->ConfigData[c].DstFont == font)
+                {
+                    font->ConfigData = &atlas->ConfigData[c];
+                }
+            }
+            font->ConfigDataCount = static_cast<short>(fontHeader.ConfigDataCount);
+            font->FontSize = fontHeader.FontSize;
+            font->Ascent = fontHeader.Ascent;
+            font->Descent = fontHeader.Descent;
+            font->MetricsTotalSurface = fontHeader.MetricsTotalSurface;
+            font->FallbackGlyph = NULL;
+            font->BuildLookupTable();
+        }
+    }
+
+    ImGuiMouseCursorData cursorData[ImGuiMouseCursor_Count_];
+    ok = ok && fread(cursorData, sizeof(cursorData), 1, file) == 1;
+
+    const size_t pixelCount = static_cast<size_t>(header.texWidth) * static_cast<size_t>(header.texHeight);
+    unsigned char* pixels = ok ? static_cast<unsigned char*>(ImGui::MemAlloc(pixelCount)) : NULL;
+    ok = ok && pixels != NULL && fread(pixels, 1, pixelCount, file) == pixelCount;
+    fclose(file);
+
+    if (!ok)
+    {
+        // Truncated file or out of memory: drop whatever was restored, the regular build starts from scratch
+        if (pixels)
+        {
+            ImGui::MemFree(pixels);
+        }
+        for (int i = 0; i < atlas->Fonts.Size; ++i)
+        {
+            atlas->Fonts[i]->Glyphs.resize(0);
+            atlas->Fonts[i]->ContainerAtlas = NULL;
+        }
+        return false;
+    }
+
+    atlas->ClearTexData();
+    atlas->TexID = NULL;
+    atlas->TexPixelsAlpha8 = pixels;
+    atlas->TexWidth = header.texWidth;
+    atlas->TexHeight = header.texHeight;
+    atlas->TexUvWhitePixel = header.texUvWhitePixel;
+    memcpy(GImGui->MouseCursorData, cursorData, sizeof(cursorData));
+    return true;
+}
+
+bool ImguiFontCache::SaveAtlas(ImFontAtlas* atlas, const char* path)
+{
+    if (atlas->TexPixelsAlpha8 == NULL || atlas->ConfigData.Size == 0 || atlas->DynamicGlyphs)
+    {
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+    header.version = CacheVersion;
+    header.inputHash = HashAtlasInputs(atlas);
+    header.texWidth = atlas->TexWidth;
+    header.texHeight = atlas->TexHeight;
+    header.texUvWhitePixel = atlas->TexUvWhitePixel;
+    header.fontCount = atlas->Fonts.Size;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (int i = 0; ok && i < atlas->Fonts.Size; ++i)
+    {
+        const ImFont* font = atlas->Fonts[i];
+        FontHeader fontHeader;
+        fontHeader.FontSize = font->FontSize;
+        fontHeader.Ascent = font->Ascent;
+        fontHeader.Descent = font->Descent;
+        fontHeader.MetricsTotalSurface = font->MetricsTotalSurface;
+        fontHeader.ConfigDataCount = font->ConfigDataCount;
+        fontHeader.GlyphCount = font->Glyphs.Size;
+        ok = fwrite(&fontHeader, sizeof(fontHeader), 1, file) == 1
+            && (font->Glyphs.Size == 0 || fwrite(font->Glyphs.Data, sizeof(ImFont::Glyph), font->Glyphs.Size, file) == static_cast<size_t>(font->Glyphs.Size));
+    }
+
+    const size_t pixelCount = static_cast<size_t>(atlas->TexWidth) * static_cast<size_t>(atlas->TexHeight);
+    ok = ok && fwrite(GImGui->MouseCursorData, sizeof(GImGui->MouseCursorData), 1, file) == 1
+            && fwrite(atlas->TexPixelsAlpha8, 1, pixelCount, file) == pixelCount;
+    fclose(file);
+
+    if (!ok)
+    {
+        remove(path); // Don't leave a truncated cache behind
+    }
+    return ok;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <imgui.h>
+
+/// Keeps the result of ImFontAtlas::Build() on disk, so that later runs skip rasterizing and packing
+/// the glyphs. A cache file is only used when it was saved for the same TTF data and font configs.
+/// Atlases with ImFontAtlas::DynamicGlyphs aren't cached, their content depends on the text displayed so far.
+namespace ImguiFontCache
+{
+    /// Restores the texture, glyphs and metrics of `atlas` from `path`.
+    /// Call after adding the fonts and before the atlas is built; returns false if it must be built normally.
+    bool LoadAtlas(ImFontAtlas* atlas, const char* path);
+
+    /// Saves a built atlas; its input data (ConfigData) must not have been cleared yet.
+    bool SaveAtlas(ImFontAtlas* atlas, const char* path);
+}
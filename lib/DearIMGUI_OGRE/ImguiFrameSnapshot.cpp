@@ -0,0 +1,38 @@
+#include "ImguiFrameSnapshot.h"
+
+ImguiFrameSnapshot::ImguiFrameSnapshot()
+    :mDisplaySize(0, 0)
+{
+}
+
+ImguiFrameSnapshot::~ImguiFrameSnapshot()
+{
+    for (int i = 0; i < mLists.Size; ++i)
+    {
+        delete mLists[i];
+    }
+}
+
+void ImguiFrameSnapshot::capture(ImDrawData* drawData, const ImVec2& displaySize)
+{
+    while (mLists.Size < drawData->CmdListsCount)
+    {
+        mLists.push_back(new ImDrawList());
+    }
+
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+    {
+        ImDrawList* src = drawData->CmdLists[i];
+        ImDrawList* dst = mLists[i];
+        dst->CmdBuffer.swap(src->CmdBuffer);
+        dst->IdxBuffer.swap(src->IdxBuffer);
+        dst->VtxBuffer.swap(src->VtxBuffer);
+    }
+
+    mDrawData.Valid         = true;
+    mDrawData.CmdLists      = mLists.Data;
+    mDrawData.CmdListsCount = drawData->CmdListsCount;
+    mDrawData.TotalVtxCount = drawData->TotalVtxCount;
+    mDrawData.TotalIdxCount = drawData->TotalIdxCount;
+    mDisplaySize = displaySize;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <imgui.h>
+
+/// Draw data of one frame which stays valid after ImGui moved on to the next frame,
+/// so the frame can be submitted by another thread while ImGui builds the next one.
+class ImguiFrameSnapshot
+{
+public:
+    ImguiFrameSnapshot();
+    ~ImguiFrameSnapshot();
+
+    /// Takes over the geometry of the frame just finished by ImGui::Render().
+    /// Buffers are swapped with ImGui's draw lists rather than copied; ImGui's lists are left with
+    /// stale content until the next NewFrame() clears them, and their capacity is reused from then on.
+    void capture(ImDrawData* drawData, const ImVec2& displaySize);
+
+    const ImDrawData* getDrawData() const { return &mDrawData; }
+    const ImVec2& getDisplaySize() const { return mDisplaySize; }
+
+private:
+    ImDrawData            mDrawData;    ///< CmdLists points into mLists.Data
+    ImVector<ImDrawList*> mLists;       ///< Owned; grows to the largest number of lists seen in a frame
+    ImVec2                mDisplaySize; ///< io.DisplaySize of the frame
+};
@@ -0,0 +1,116 @@
+#if defined(_MSC_VER) && !defined(_CRT_SECURE_NO_WARNINGS)
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "ImguiFrameTimings.h"
+
+#include <algorithm> // std::sort
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static const char* const StageNames[ImguiFrameTimings::ST_COUNT] =
+{
+    "NewFrame",
+    "User build",
+    "Render",
+    "Upload",
+    "Submit",
+};
+
+// Nearest rank on sorted samples
+static float PercentileOfSorted(const float* sorted, int count, float percentile)
+{
+    if (count == 0)
+    {
+        return 0.f;
+    }
+    int rank = static_cast<int>(percentile / 100.f * count + 0.5f);
+    rank = std::max(1, std::min(rank, count));
+    return sorted[rank - 1];
+}
+
+ImguiFrameTimings::ImguiFrameTimings()
+{
+    this->clear();
+}
+
+double ImguiFrameTimings::getTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* ImguiFrameTimings::getStageName(Stage stage)
+{
+    return StageNames[stage];
+}
+
+void ImguiFrameTimings::record(Stage stage, double seconds)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    History& history = mHistory[stage];
+    history.samples[history.next] = static_cast<float>(seconds * 1000.0);
+    history.next = (history.next + 1) % HistorySize;
+    history.count = std::min(history.count + 1, static_cast<int>(HistorySize));
+}
+
+void ImguiFrameTimings::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    memset(mHistory, 0, sizeof(mHistory));
+}
+
+float ImguiFrameTimings::getPercentile(Stage stage, float percentile) const
+{
+    float sorted[HistorySize];
+    int count = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        count = this->copyHistory(stage, sorted, HistorySize);
+    }
+    std::sort(sorted, sorted + count);
+    return PercentileOfSorted(sorted, count, percentile);
+}
+
+int ImguiFrameTimings::getHistory(Stage stage, float* out, int maxCount) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return this->copyHistory(stage, out, maxCount);
+}
+
+int ImguiFrameTimings::copyHistory(Stage stage, float* out, int maxCount) const
+{
+    const History& history = mHistory[stage];
+    const int count = std::min(history.count, maxCount);
+    for (int i = 0; i < count; ++i)
+    {
+        out[i] = history.samples[(history.next - count + i + HistorySize) % HistorySize];
+    }
+    return count;
+}
+
+void ImguiFrameTimings::showOverlay(bool* open) const
+{
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiSetCond_FirstUseEver);
+    if (!ImGui::Begin("Frame timings", open, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        ImGui::End();
+        return;
+    }
+
+    float samples[HistorySize];
+    float sorted[HistorySize];
+    for (int s = 0; s < ST_COUNT; ++s)
+    {
+        const int count = this->getHistory(static_cast<Stage>(s), samples, HistorySize);
+        memcpy(sorted, samples, count * sizeof(float));
+        std::sort(sorted, sorted + count);
+
+        char overlay[64];
+        sprintf(overlay, "p50 %.3f  p95 %.3f  p99 %.3f ms", PercentileOfSorted(sorted, count, 50.f),
+                PercentileOfSorted(sorted, count, 95.f), PercentileOfSorted(sorted, count, 99.f));
+        // Scaled from zero to the slowest sample, so the stages can be compared by eye
+        ImGui::PlotLines(StageNames[s], samples, count, 0, overlay, 0.f, count > 0 ? sorted[count - 1] : 1.f, ImVec2(320, 48));
+    }
+    ImGui::End();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <mutex>
+
+/// Rolling history of how long each stage of the UI frames took, with percentiles and an overlay window.
+/// Stages are recorded by the UI thread and the render thread, so every method locks.
+class ImguiFrameTimings
+{
+public:
+    enum Stage
+    {
+        ST_NEW_FRAME,   ///< OgreImGui::NewFrame(): input and ImGui::NewFrame()
+        ST_USER_BUILD,  ///< Application UI code, between NewFrame() and EndFrame()
+        ST_RENDER,      ///< ImGui::Render() and the frame snapshot
+        ST_UPLOAD,      ///< Vertex/index uploads to the hardware buffers
+        ST_SUBMIT,      ///< Scissor, texture and draw calls
+        ST_COUNT
+    };
+
+    static const int HistorySize = 240; ///< Samples kept per stage
+
+    ImguiFrameTimings();
+
+    /// Seconds on a high resolution steady clock
+    static double getTime();
+    static const char* getStageName(Stage stage);
+
+    void record(Stage stage, double seconds);
+    void clear();
+
+    /// Duration in milliseconds which `percentile` (0-100) of the recorded samples don't exceed; 0 without samples
+    float getPercentile(Stage stage, float percentile) const;
+    /// Copies up to `maxCount` of the latest samples, oldest first, in milliseconds; returns how many were copied
+    int getHistory(Stage stage, float* out, int maxCount) const;
+
+    /// Window with a plot and p50/p95/p99 per stage; call between NewFrame() and EndFrame()
+    void showOverlay(bool* open = NULL) const;
+
+private:
+    struct History
+    {
+        float samples[HistorySize]; ///< Milliseconds, ring buffer
+        int   count;
+        int   next;                 ///< Slot the next sample goes to
+    };
+
+    int copyHistory(Stage stage, float* out, int maxCount) const; ///< Caller holds mMutex
+
+    History            mHistory[ST_COUNT];
+    mutable std::mutex mMutex;
+};
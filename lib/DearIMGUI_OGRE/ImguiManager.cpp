@@ -1,5 +1,7 @@
 #include <imgui.h>
+#include <imgui_internal.h> // IM_ARRAYSIZE
 #include "ImguiManager.h"
+#include "ImguiFontCache.h"
 
 #include <OgreMaterialManager.h>
 #include <OgreMesh.h>
@@ -19,6 +21,39 @@
 #include <OgreViewport.h>
 #include <OgreHardwarePixelBuffer.h>
 #include <OgreRenderTarget.h>
+#include <OgreGpuProgramManager.h>
+#include <OgreLogManager.h>
+
+#include <algorithm> // std::min, std::max
+#include <string.h>
+#include <utility> // std::swap
+
+// Timestamps of the queued input
+static double GetInputTime()
+{
+    return ImguiFrameTimings::getTime();
+}
+
+// Formats the fragment programs read glyph coverage from: a luminance/red-only texture, drawn with AlphaTexture = 1
+static bool IsCoverageFormat(Ogre::PixelFormat format)
+{
+    return Ogre::PixelUtil::getComponentCount(format) == 1 && !Ogre::PixelUtil::hasAlpha(format);
+}
+
+// Coverage replicated to all four channels, for font textures which can't hold it alone. The fragment
+// programs still read it from .r, so the channel order of the texture doesn't matter.
+static void ExpandCoverage(const unsigned char* coverage, int count, ImVector<ImU32>& texels)
+{
+    texels.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        texels[i] = IM_COL32(coverage[i], coverage[i], coverage[i], coverage[i]);
+    }
+}
+
+// UI frames built after the last input or animation before needsFrame() reports idle:
+// new windows auto-fit and hover states resolve over a couple of frames
+static const int UiSettleFrameCount = 3;
 
 OgreImGui::OgreImGui()
     :mSceneMgr(0)
@@ -26,8 +61,26 @@ OgreImGui::OgreImGui()
     ,OIS::KeyListener()
     ,mKeyInput(0)
     ,mMouseInput(0)
+    ,mTexUnit(0)
+    ,mFontDistanceField(0.f)
+    ,mRenderable(0)
+    ,mFrontSnapshot(&mSnapshots[0])
+    ,mBackSnapshot(&mSnapshots[1])
+    ,mHasFrame(false)
+    ,mUserBuildStartTime(0.0)
+    ,mInvalidated(false)
+    ,mInvalidateTime(0.0)
+    ,mRenderOnDemand(false)
+    ,mSettleFrames(0)
+    ,mShaderCachePath("imgui_shaders.cache")
+    ,mFontCachePath("imgui_fonts.cache")
 {
+}
 
+OgreImGui::~OgreImGui()
+{
+    // GPU resources must be released via Shutdown() while Ogre is still alive
+    assert(mRenderable == 0);
 }
 
 void OgreImGui::Init(Ogre::SceneManager * mgr,OIS::Keyboard* keyInput, OIS::Mouse* mouseInput)
@@ -60,36 +113,71 @@ void OgreImGui::Init(Ogre::SceneManager * mgr,OIS::Keyboard* keyInput, OIS::Mous
 
     createFontTexture();
     createMaterial();
+
+    io.Fonts->TexID = this->registerTexture(mFontTex);
+
+    mRenderable = OGRE_NEW ImGUIRenderable(this);
+    mBatchRenderer.setDevice(mRenderable);
 }
 
-//Inherhited from OIS::MouseListener
-bool OgreImGui::mouseMoved( const OIS::MouseEvent &arg )
+void OgreImGui::Shutdown()
 {
+    mBatchRenderer.setDevice(0);
+    OGRE_DELETE mRenderable;
+    mRenderable = 0;
+    {
+        std::lock_guard<std::mutex> lock(mTexturesMutex);
+        mTextures.clear();
+    }
+    mFontTex.setNull();
+}
 
-    ImGuiIO& io = ImGui::GetIO();
+ImTextureID OgreImGui::registerTexture(const Ogre::TexturePtr& tex)
+{
+    ImTextureID texId = static_cast<ImTextureID>(tex.get());
+    std::lock_guard<std::mutex> lock(mTexturesMutex);
+    mTextures[texId] = tex;
+    return texId;
+}
 
-    io.MousePos.x = static_cast<float>(arg.state.X.abs);
-    io.MousePos.y = static_cast<float>(arg.state.Y.abs);
+void OgreImGui::unregisterTexture(ImTextureID texId)
+{
+    if (texId != static_cast<ImTextureID>(mFontTex.get())) // The font atlas lives until Shutdown()
+    {
+        std::lock_guard<std::mutex> lock(mTexturesMutex);
+        mTextures.erase(texId);
+    }
+}
 
+// Returns a reference counted copy, which keeps the texture alive while it is bound even if it gets unregistered meanwhile
+Ogre::TexturePtr OgreImGui::getTexture(ImTextureID texId)
+{
+    std::lock_guard<std::mutex> lock(mTexturesMutex);
+    TextureRegistry::iterator itor = mTextures.find(texId);
+    return (itor != mTextures.end()) ? itor->second : mFontTex; // Unregistered IDs fall back to the font atlas
+}
+
+//Inherhited from OIS::MouseListener
+bool OgreImGui::mouseMoved( const OIS::MouseEvent &arg )
+{
+    queueInputEvent(InputEvent::MouseMove, 0, false, static_cast<float>(arg.state.X.abs), static_cast<float>(arg.state.Y.abs));
     return true;
 }
 
 bool OgreImGui::mousePressed( const OIS::MouseEvent &arg, OIS::MouseButtonID id )
 {
-    ImGuiIO& io = ImGui::GetIO();
     if(id<5)
     {
-        io.MouseDown[id] = true;
+        queueInputEvent(InputEvent::MouseButton, id, true);
     }
     return true;
 }
 
 bool OgreImGui::mouseReleased( const OIS::MouseEvent &arg, OIS::MouseButtonID id )
 {
-    ImGuiIO& io = ImGui::GetIO();
     if(id<5)
     {
-        io.MouseDown[id] = false;
+        queueInputEvent(InputEvent::MouseButton, id, false);
     }
     return true;
 }
@@ -97,12 +185,11 @@ bool OgreImGui::mouseReleased( const OIS::MouseEvent &arg, OIS::MouseButtonID id
 // Inherhited from OIS::KeyListener
 bool OgreImGui::keyPressed( const OIS::KeyEvent &arg )
 {
-    ImGuiIO& io = ImGui::GetIO();
-    io.KeysDown[arg.key] = true;
+    queueInputEvent(InputEvent::Key, arg.key, true);
 
     if(arg.text>0)
     {
-        io.AddInputCharacter((unsigned short)arg.text);
+        queueInputEvent(InputEvent::Character, static_cast<int>(arg.text), true);
     }
 
     return true;
@@ -110,25 +197,283 @@ bool OgreImGui::keyPressed( const OIS::KeyEvent &arg )
 
 bool OgreImGui::keyReleased( const OIS::KeyEvent &arg )
 {
-    ImGuiIO& io = ImGui::GetIO();
-    io.KeysDown[arg.key] = false;
+    queueInputEvent(InputEvent::Key, arg.key, false);
     return true;
 }
 
+void OgreImGui::queueInputEvent(InputEvent::Type type, int code, bool down, float x, float y)
+{
+    InputEvent event;
+    event.type = type;
+    event.time = GetInputTime();
+    event.code = code;
+    event.down = down;
+    event.x = x;
+    event.y = y;
+
+    std::lock_guard<std::mutex> lock(mInputMutex);
+    mInputQueue.push_back(event);
+}
+
+// Applies the events which arrived up to frameTime, in order. Once a button or key changed, the next event changing it
+// again waits for the next frame, and so does everything queued after it: later events keep seeing the state they were
+// sent in (e.g. a release after a move happens at the new mouse position).
+void OgreImGui::applyInputEvents(double frameTime)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    bool mouseChanged[IM_ARRAYSIZE(io.MouseDown)] = {};
+    bool keyChanged[IM_ARRAYSIZE(io.KeysDown)] = {};
+    int charCount = 0;
+    while (charCount < IM_ARRAYSIZE(io.InputCharacters) && io.InputCharacters[charCount] != 0)
+    {
+        ++charCount;
+    }
+
+    std::lock_guard<std::mutex> lock(mInputMutex);
+    int applied = 0;
+    for (; applied < mInputQueue.Size; ++applied)
+    {
+        const InputEvent& event = mInputQueue[applied];
+        if (event.time > frameTime)
+        {
+            break; // Sent while the frame was starting, belongs to the next one
+        }
+
+        if (event.type == InputEvent::MouseMove)
+        {
+            io.MousePos = ImVec2(event.x, event.y);
+        }
+        else if (event.type == InputEvent::MouseButton || event.type == InputEvent::Key)
+        {
+            const bool isMouse = event.type == InputEvent::MouseButton;
+            if (!isMouse && (event.code < 0 || event.code >= IM_ARRAYSIZE(io.KeysDown)))
+            {
+                continue;
+            }
+            bool& down = isMouse ? io.MouseDown[event.code] : io.KeysDown[event.code];
+            bool& changed = isMouse ? mouseChanged[event.code] : keyChanged[event.code];
+            if (down != event.down)
+            {
+                if (changed)
+                {
+                    break;
+                }
+                down = event.down;
+                changed = true;
+            }
+        }
+        else
+        {
+            if (charCount >= IM_ARRAYSIZE(io.InputCharacters) - 1)
+            {
+                break; // ImGui's buffer is full, the rest is typed next frame
+            }
+            io.AddInputCharacter(static_cast<ImWchar>(event.code));
+            ++charCount;
+        }
+    }
+
+    if (applied > 0)
+    {
+        memmove(mInputQueue.Data, mInputQueue.Data + applied, (mInputQueue.Size - applied) * sizeof(InputEvent));
+        mInputQueue.resize(mInputQueue.Size - applied);
+        mSettleFrames = UiSettleFrameCount;
+    }
+}
+
+bool OgreImGui::needsFrame(float displayWidth, float displayHeight)
+{
+    const ImGuiIO& io = ImGui::GetIO();
+    if (!mRenderOnDemand || !mHasFrame || mSettleFrames > 0 || io.DisplaySize.x != displayWidth || io.DisplaySize.y != displayHeight)
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mInputMutex);
+    if (mInvalidated || mInputQueue.Size > 0)
+    {
+        mInvalidated = false;
+        return true;
+    }
+    if (mInvalidateTime > 0.0 && GetInputTime() >= mInvalidateTime)
+    {
+        mInvalidateTime = 0.0;
+        return true;
+    }
+    return false;
+}
+
+void OgreImGui::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mInputMutex);
+    mInvalidated = true;
+}
+
+void OgreImGui::invalidateAfter(double seconds)
+{
+    const double time = GetInputTime() + seconds;
+    std::lock_guard<std::mutex> lock(mInputMutex);
+    if (mInvalidateTime <= 0.0 || time < mInvalidateTime)
+    {
+        mInvalidateTime = time;
+    }
+}
+
+// ImGui changes from frame to frame without new input while an item is active (dragging, the text cursor blinking),
+// while a modal window fades the background in, and while a mouse button or key is held (drag scrolling, key repeat)
+bool OgreImGui::isUiAnimating() const
+{
+    const ImGuiIO& io = ImGui::GetIO();
+    const ImGuiContext& g = *GImGui;
+    if (g.ActiveId != 0 || io.WantTextInput || (g.ModalWindowDarkeningRatio > 0.f && g.ModalWindowDarkeningRatio < 1.f))
+    {
+        return true;
+    }
+    for (int i = 0; i < IM_ARRAYSIZE(io.MouseDown); ++i)
+    {
+        if (io.MouseDown[i])
+        {
+            return true;
+        }
+    }
+    for (int i = 0; i < IM_ARRAYSIZE(io.KeysDown); ++i)
+    {
+        if (io.KeysDown[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void OgreImGui::EndFrame()
+{
+    const double startTime = ImguiFrameTimings::getTime();
+    mFrameTimings.record(ImguiFrameTimings::ST_USER_BUILD, startTime - mUserBuildStartTime);
+
+    ImGui::Render();
+    if (isUiAnimating())
+    {
+        mSettleFrames = UiSettleFrameCount;
+    }
+    else if (mSettleFrames > 0)
+    {
+        --mSettleFrames;
+    }
+    if (GImGui->SettingsDirtyTimer > 0.f)
+    {
+        // The .ini is saved by the NewFrame() where the timer runs out; idle frames would postpone it
+        // indefinitely. That single frame is enough: the skipped frames are part of its delta time.
+        invalidateAfter(GImGui->SettingsDirtyTimer);
+    }
+    mBackSnapshot->capture(ImGui::GetDrawData(), ImGui::GetIO().DisplaySize);
+    mFrameTimings.record(ImguiFrameTimings::ST_RENDER, ImguiFrameTimings::getTime() - startTime);
+
+    // Publish the frame; waits if render() is still submitting the previous one
+    std::lock_guard<std::mutex> lock(mSnapshotMutex);
+    std::swap(mFrontSnapshot, mBackSnapshot);
+    mHasFrame = true;
+
+    // Glyphs rasterized during the frame; the atlas belongs to this thread, so render() gets a copy
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    if (atlas->IsTexDirty())
+    {
+        queueFontTextureUpdate(atlas);
+        atlas->ClearTexDirtyRect();
+    }
+}
+
+OgreImGui::FontTexUpdate::FontTexUpdate()
+    :texWidth(0)
+    ,texHeight(0)
+    ,x0(0)
+    ,y0(0)
+    ,x1(0)
+    ,y1(0)
+{
+}
+
+void OgreImGui::queueFontTextureUpdate(ImFontAtlas* atlas)
+{
+    // Merge with an update render() didn't get to yet. The atlas only ever gains pixels,
+    // so copying the union from its current content covers both.
+    FontTexUpdate& update = mFontTexUpdate;
+    const ImVec4& dirty = atlas->TexDirtyRect;
+    if (update.x0 < update.x1 && update.texWidth == atlas->TexWidth)
+    {
+        update.x0 = std::min(update.x0, static_cast<int>(dirty.x));
+        update.y0 = std::min(update.y0, static_cast<int>(dirty.y));
+        update.x1 = std::max(update.x1, static_cast<int>(dirty.z));
+        update.y1 = std::max(update.y1, static_cast<int>(dirty.w));
+    }
+    else
+    {
+        update.x0 = static_cast<int>(dirty.x);
+        update.y0 = static_cast<int>(dirty.y);
+        update.x1 = static_cast<int>(dirty.z);
+        update.y1 = static_cast<int>(dirty.w);
+    }
+    update.texWidth = atlas->TexWidth;
+    update.texHeight = atlas->TexHeight;
+
+    const int rowBytes = atlas->TexWidth;
+    update.rows.resize((update.y1 - update.y0) * rowBytes);
+    memcpy(update.rows.Data, atlas->TexPixelsAlpha8 + update.y0 * rowBytes, update.rows.Size);
+}
+
+void OgreImGui::updateFontTexture()
+{
+    FontTexUpdate& update = mFontTexUpdate;
+    if (update.x0 >= update.x1)
+    {
+        return;
+    }
+
+    if (mFontTex->getWidth() != static_cast<Ogre::uint32>(update.texWidth) || mFontTex->getHeight() != static_cast<Ogre::uint32>(update.texHeight))
+    {
+        // The atlas grew. Resize in place: the texture's address is the ImTextureID used by the draw lists.
+        // The whole atlas is dirty after growing, so the new storage is filled below.
+        mFontTex->freeInternalResources();
+        mFontTex->setWidth(update.texWidth);
+        mFontTex->setHeight(update.texHeight);
+        mFontTex->createInternalResources();
+    }
+
+    Ogre::PixelBox rows(update.texWidth, update.y1 - update.y0, 1, Ogre::PF_L8, update.rows.Data);
+    ImVector<ImU32> texels;
+    if (!IsCoverageFormat(mFontTex->getFormat()))
+    {
+        ExpandCoverage(update.rows.Data, update.rows.Size, texels);
+        rows = Ogre::PixelBox(update.texWidth, update.y1 - update.y0, 1, Ogre::PF_A8R8G8B8, texels.Data);
+    }
+    mFontTex->getBuffer()->blitFromMemory(rows.getSubVolume(Ogre::Box(update.x0, 0, update.x1, update.y1 - update.y0)),
+                                          Ogre::Box(update.x0, update.y0, update.x1, update.y1));
+    update.x0 = update.y0 = update.x1 = update.y1 = 0;
+}
+
 void OgreImGui::render()
 {
+    // The front snapshot must not be swapped out while its geometry is being submitted
+    std::lock_guard<std::mutex> lock(mSnapshotMutex);
+    if (!mHasFrame)
+    {
+        return;
+    }
+    const ImguiFrameSnapshot* frame = mFrontSnapshot;
+    updateFontTexture();
+
     // Construct projection matrix, taking texel offset corrections in account (important for DirectX9)
     // See also:
     //     - OGRE-API specific hint: http://www.ogre3d.org/forums/viewtopic.php?f=5&p=536881#p536881
     //     - IMGUI Dx9 demo solution: https://github.com/ocornut/imgui/blob/master/examples/directx9_example/imgui_impl_dx9.cpp#L127-L138
-    ImGuiIO& io = ImGui::GetIO();
+    const ImVec2& displaySize = frame->getDisplaySize();
     Ogre::RenderSystem* renderSys = Ogre::Root::getSingletonPtr()->getRenderSystem();
     const float texelOffsetX = renderSys->getHorizontalTexelOffset();
     const float texelOffsetY = renderSys->getVerticalTexelOffset();
     const float L = texelOffsetX;
-    const float R = io.DisplaySize.x + texelOffsetX;
+    const float R = displaySize.x + texelOffsetX;
     const float T = texelOffsetY;
-    const float B = io.DisplaySize.y + texelOffsetY;
+    const float B = displaySize.y + texelOffsetY;
 
     Ogre::Matrix4 projMatrix(       2.0f/(R-L),    0.0f,         0.0f,       (L+R)/(L-R),
                                     0.0f,         -2.0f/(B-T),   0.0f,       (T+B)/(B-T),
@@ -137,47 +482,13 @@ void OgreImGui::render()
 
     mPass->getVertexProgramParameters()->setNamedConstant("ProjectionMatrix", projMatrix);
 
-    // Instruct ImGui to Render() and process the resulting CmdList-s
+    // Process the CmdList-s of the snapshot
     /// Adopted from https://bitbucket.org/ChaosCreator/imgui-ogre2.1-binding
     /// ... Commentary on OGRE forums: http://www.ogre3d.org/forums/viewtopic.php?f=5&t=89081#p531059
-    ImGui::Render();
-    ImDrawData* draw_data = ImGui::GetDrawData();
     Ogre::Viewport* vp = renderSys->_getViewport();
-    int vpWidth  = vp->getActualWidth();
-    int vpHeight = vp->getActualHeight();
-    for (int i = 0; i < draw_data->CmdListsCount; ++i)
-    {
-        const ImDrawList* draw_list = draw_data->CmdLists[i];
-        unsigned int startIdx = 0;
-
-        for (int j = 0; j < draw_list->CmdBuffer.Size; ++j)
-        {
-            // Create a renderable and fill it's buffers
-            ImGUIRenderable renderable;
-            const ImDrawCmd *drawCmd = &draw_list->CmdBuffer[j];
-            renderable.updateVertexData(draw_list->VtxBuffer.Data, &draw_list->IdxBuffer.Data[startIdx], draw_list->VtxBuffer.Size, drawCmd->ElemCount);
-
-            // Set scissoring
-            int scLeft   = static_cast<int>(drawCmd->ClipRect.x); // Obtain bounds
-            int scTop    = static_cast<int>(drawCmd->ClipRect.y);
-            int scRight  = static_cast<int>(drawCmd->ClipRect.z);
-            int scBottom = static_cast<int>(drawCmd->ClipRect.w);
-
-            scLeft   = scLeft   < 0 ? 0 : (scLeft  > vpWidth ? vpWidth : scLeft); // Clamp bounds to viewport dimensions
-            scRight  = scRight  < 0 ? 0 : (scRight > vpWidth ? vpWidth : scRight);
-            scTop    = scTop    < 0 ? 0 : (scTop    > vpHeight ? vpHeight : scTop);
-            scBottom = scBottom < 0 ? 0 : (scBottom > vpHeight ? vpHeight : scBottom);
-
-            renderSys->setScissorTest(true, scLeft, scTop, scRight, scBottom);
-
-            // Render!
-            mSceneMgr->_injectRenderWithPass(mPass, &renderable, 0, false, false);
-
-            // Update counts
-            startIdx += drawCmd->ElemCount;
-        }
-    }
-    renderSys->setScissorTest(false);
+    mBatchRenderer.render(frame->getDrawData(), vp->getActualWidth(), vp->getActualHeight());
+    mFrameTimings.record(ImguiFrameTimings::ST_UPLOAD, mBatchRenderer.getRenderStats().uploadTime);
+    mFrameTimings.record(ImguiFrameTimings::ST_SUBMIT, mBatchRenderer.getRenderStats().submitTime);
 }
 
 void OgreImGui::createMaterial()
@@ -220,10 +531,16 @@ void OgreImGui::createMaterial()
     "};\n"
     "sampler sampler0;\n"
     "Texture2D texture0;\n"
+    "float AlphaTexture; \n"
+    "float DistanceField; \n"
     "\n"
     "float4 main(PS_INPUT input) : SV_Target\n"
     "{\n"
-    "float4 out_col = input.col * texture0.Sample(sampler0, input.uv); \n"
+    "float4 tex_col = texture0.Sample(sampler0, input.uv); \n"
+    "float dist_ramp = max(fwidth(tex_col.r), 0.0001f); \n"
+    "tex_col.r = lerp(tex_col.r, saturate((tex_col.r - 0.5f) / dist_ramp + 0.5f), step(0.0001f, DistanceField)); \n"
+    "tex_col = lerp(tex_col, float4(1.f, 1.f, 1.f, tex_col.r), AlphaTexture); \n"
+    "float4 out_col = input.col * tex_col; \n"
     "return out_col; \n"
     "}"
     };
@@ -262,10 +579,16 @@ void OgreImGui::createMaterial()
     "float2 uv  : TEXCOORD0;\n"
     "};\n"
     "sampler2D sampler0;\n"
+    "uniform float AlphaTexture; \n"
+    "uniform float DistanceField; \n"
     "\n"
     "float4 main(PS_INPUT input) : SV_Target\n"
     "{\n"
-    "float4 out_col = input.col.bgra * tex2D(sampler0, input.uv); \n"
+    "float4 tex_col = tex2D(sampler0, input.uv); \n"
+    "float dist_ramp = max(DistanceField, 0.0001f); \n"
+    "tex_col.r = lerp(tex_col.r, saturate((tex_col.r - 0.5f) / dist_ramp + 0.5f), step(0.0001f, DistanceField)); \n"
+    "tex_col = lerp(tex_col, float4(1.f, 1.f, 1.f, tex_col.r), AlphaTexture); \n"
+    "float4 out_col = input.col.bgra * tex_col; \n"
     "return out_col; \n"
     "}"
     };
@@ -293,28 +616,53 @@ void OgreImGui::createMaterial()
     "in vec2 Texcoord;\n"
     "in vec4 col;\n"
     "uniform sampler2D sampler0;\n"
+    "uniform float AlphaTexture;\n"
+    "uniform float DistanceField;\n"
     "out vec4 out_col;\n"
     "void main()\n"
     "{\n"
-    "out_col = col * texture(sampler0, Texcoord); \n"
+    "vec4 tex_col = texture(sampler0, Texcoord); \n"
+    "float dist_ramp = max(fwidth(tex_col.r), 0.0001); \n"
+    "tex_col.r = mix(tex_col.r, clamp((tex_col.r - 0.5) / dist_ramp + 0.5, 0.0, 1.0), step(0.0001, DistanceField)); \n"
+    "tex_col = mix(tex_col, vec4(1.0, 1.0, 1.0, tex_col.r), AlphaTexture); \n"
+    "out_col = col * tex_col; \n"
     "}"
     };
 
+    // Programs are only created for the render system in use, picked by a profile only it supports
+    struct ShaderVariant
+    {
+        const char* name;       // Suffix of the program names
+        const char* language;
+        const char* syntax;     // Identifies the render system
+        const char* vsTarget;   // NULL for languages without compile targets
+        const char* psTarget;
+        const char* vsSource;
+        const char* psSource;
+    };
+    static const ShaderVariant variants[] =
+    {
+        { "D3D11", "hlsl", "vs_4_0", "vs_4_0", "ps_4_0", vertexShaderSrcD3D11, pixelShaderSrcD3D11 },
+        { "D3D9",  "hlsl", "vs_2_0", "vs_2_0", "ps_2_0", vertexShaderSrcD3D9,  pixelShaderSrcSrcD3D9 },
+        { "GL150", "glsl", "glsl",   NULL,     NULL,     vertexShaderSrcGLSL,  pixelShaderSrcGLSL },
+    };
+
+    const ShaderVariant* variant = NULL;
+    for (size_t i = 0; i < sizeof(variants) / sizeof(variants[0]); ++i)
+    {
+        if (Ogre::GpuProgramManager::getSingleton().isSyntaxSupported(variants[i].syntax))
+        {
+            variant = &variants[i];
+            break;
+        }
+    }
+
     //create the default shadows material
     Ogre::HighLevelGpuProgramManager& mgr = Ogre::HighLevelGpuProgramManager::getSingleton();
 
     Ogre::HighLevelGpuProgramPtr vertexShaderUnified = mgr.getByName("imgui/VP");
     Ogre::HighLevelGpuProgramPtr pixelShaderUnified = mgr.getByName("imgui/FP");
-    
-    Ogre::HighLevelGpuProgramPtr vertexShaderD3D11 = mgr.getByName("imgui/VP/D3D11");
-    Ogre::HighLevelGpuProgramPtr pixelShaderD3D11 = mgr.getByName("imgui/FP/D3D11");
 
-    Ogre::HighLevelGpuProgramPtr vertexShaderD3D9 = mgr.getByName("imgui/VP/D3D9");
-    Ogre::HighLevelGpuProgramPtr pixelShaderD3D9 = mgr.getByName("imgui/FP/D3D9");
-
-    Ogre::HighLevelGpuProgramPtr vertexShaderGL = mgr.getByName("imgui/VP/GL150");
-    Ogre::HighLevelGpuProgramPtr pixelShaderGL = mgr.getByName("imgui/FP/GL150");
-    
     if(vertexShaderUnified.isNull())
     {
         vertexShaderUnified = mgr.createProgram("imgui/VP",Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,"unified",Ogre::GPT_VERTEX_PROGRAM);
@@ -327,72 +675,60 @@ void OgreImGui::createMaterial()
     Ogre::UnifiedHighLevelGpuProgram* vertexShaderPtr = static_cast<Ogre::UnifiedHighLevelGpuProgram*>(vertexShaderUnified.get());
     Ogre::UnifiedHighLevelGpuProgram* pixelShaderPtr = static_cast<Ogre::UnifiedHighLevelGpuProgram*>(pixelShaderUnified.get());
 
-    if (vertexShaderD3D11.isNull())
-    {
-        vertexShaderD3D11 = mgr.createProgram("imgui/VP/D3D11", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-                "hlsl", Ogre::GPT_VERTEX_PROGRAM);
-        vertexShaderD3D11->setParameter("target", "vs_4_0");
-        vertexShaderD3D11->setParameter("entry_point", "main");
-        vertexShaderD3D11->setSource(vertexShaderSrcD3D11);
-        vertexShaderD3D11->load();
-
-        vertexShaderPtr->addDelegateProgram(vertexShaderD3D11->getName());
-    }
-
-    if (pixelShaderD3D11.isNull())
-    {
-        pixelShaderD3D11 = mgr.createProgram("imgui/FP/D3D11", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-                "hlsl", Ogre::GPT_FRAGMENT_PROGRAM);
-        pixelShaderD3D11->setParameter("target", "ps_4_0");
-        pixelShaderD3D11->setParameter("entry_point", "main");
-        pixelShaderD3D11->setSource(pixelShaderSrcD3D11);
-        pixelShaderD3D11->load();
-
-        pixelShaderPtr->addDelegateProgram(pixelShaderD3D11->getName());
-    }
-
-    if (vertexShaderD3D9.isNull())
+    if (variant == NULL)
     {
-        vertexShaderD3D9 = mgr.createProgram("imgui/VP/D3D9", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-            "hlsl", Ogre::GPT_VERTEX_PROGRAM);
-        vertexShaderD3D9->setParameter("target", "vs_2_0");
-        vertexShaderD3D9->setParameter("entry_point", "main");
-        vertexShaderD3D9->setSource(vertexShaderSrcD3D9);
-        vertexShaderD3D9->load();
-
-        vertexShaderPtr->addDelegateProgram(vertexShaderD3D9->getName());
+        Ogre::LogManager::getSingleton().logMessage("ImGui: no shader variant for render system "
+            + Ogre::Root::getSingleton().getRenderSystem()->getName(), Ogre::LML_CRITICAL);
     }
-
-    if (pixelShaderD3D9.isNull())
+    else
     {
-        pixelShaderD3D9 = mgr.createProgram("imgui/FP/D3D9", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-            "hlsl", Ogre::GPT_FRAGMENT_PROGRAM);
-        pixelShaderD3D9->setParameter("target", "ps_2_0");
-        pixelShaderD3D9->setParameter("entry_point", "main");
-        pixelShaderD3D9->setSource(pixelShaderSrcSrcD3D9);
-        pixelShaderD3D9->load();
-
-        pixelShaderPtr->addDelegateProgram(pixelShaderD3D9->getName());
-    }
-
-    if (vertexShaderGL.isNull())
-    {
-        vertexShaderGL = mgr.createProgram("imgui/VP/GL150", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-                "glsl", Ogre::GPT_VERTEX_PROGRAM);
-        vertexShaderGL->setSource(vertexShaderSrcGLSL);
-        vertexShaderGL->load();
-        vertexShaderPtr->addDelegateProgram(vertexShaderGL->getName());
-    }
+        // The cache is keyed by program name; the source hash makes sure edited shaders aren't served stale
+        Ogre::uint32 sourceHash = Ogre::FastHash(variant->vsSource, static_cast<int>(strlen(variant->vsSource)));
+        sourceHash = Ogre::FastHash(variant->psSource, static_cast<int>(strlen(variant->psSource)), sourceHash);
+        Ogre::GpuProgramManager& gpuMgr = Ogre::GpuProgramManager::getSingleton();
+        const bool saveMicrocodes = gpuMgr.getSaveMicrocodesToCache(); // Application setting, changed by loadShaderCache()
+        this->loadShaderCache(sourceHash);
+
+        const Ogre::String vsName = Ogre::String("imgui/VP/") + variant->name;
+        Ogre::HighLevelGpuProgramPtr vertexShader = mgr.getByName(vsName);
+        if (vertexShader.isNull())
+        {
+            vertexShader = mgr.createProgram(vsName, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+                    variant->language, Ogre::GPT_VERTEX_PROGRAM);
+            if (variant->vsTarget != NULL)
+            {
+                vertexShader->setParameter("target", variant->vsTarget);
+                vertexShader->setParameter("entry_point", "main");
+            }
+            vertexShader->setSource(variant->vsSource);
+            vertexShader->load();
+
+            vertexShaderPtr->addDelegateProgram(vertexShader->getName());
+        }
 
-    if (pixelShaderGL.isNull())
-    {
-        pixelShaderGL = mgr.createProgram("imgui/FP/GL150", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-                "glsl", Ogre::GPT_FRAGMENT_PROGRAM);
-        pixelShaderGL->setSource(pixelShaderSrcGLSL);
-        pixelShaderGL->load();
-        pixelShaderGL->setParameter("sampler0","int 0");
+        const Ogre::String psName = Ogre::String("imgui/FP/") + variant->name;
+        Ogre::HighLevelGpuProgramPtr pixelShader = mgr.getByName(psName);
+        if (pixelShader.isNull())
+        {
+            pixelShader = mgr.createProgram(psName, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+                    variant->language, Ogre::GPT_FRAGMENT_PROGRAM);
+            if (variant->psTarget != NULL)
+            {
+                pixelShader->setParameter("target", variant->psTarget);
+                pixelShader->setParameter("entry_point", "main");
+            }
+            pixelShader->setSource(variant->psSource);
+            pixelShader->load();
+            if (variant->psTarget == NULL)
+            {
+                pixelShader->setParameter("sampler0","int 0"); // GLSL: bind the sampler to texture unit 0
+            }
+
+            pixelShaderPtr->addDelegateProgram(pixelShader->getName());
+        }
 
-        pixelShaderPtr->addDelegateProgram(pixelShaderGL->getName());
+        this->saveShaderCache(sourceHash);
+        gpuMgr.setSaveMicrocodesToCache(saveMicrocodes);
     }
 
     Ogre::MaterialPtr imguiMaterial = Ogre::MaterialManager::getSingleton().create("imgui/material", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
@@ -406,9 +742,59 @@ void OgreImGui::createMaterial()
     mPass->setSeparateSceneBlendingOperation(Ogre::SBO_ADD,Ogre::SBO_ADD);
     mPass->setSeparateSceneBlending(Ogre::SBF_SOURCE_ALPHA,Ogre::SBF_ONE_MINUS_SOURCE_ALPHA,Ogre::SBF_ONE_MINUS_SOURCE_ALPHA,Ogre::SBF_ZERO);
 
-    Ogre::TextureUnitState* texUnit =  mPass->createTextureUnitState();
-    texUnit->setTexture(mFontTex);
-    texUnit->setTextureFiltering(Ogre::TFO_NONE);
+    // Single channel textures (the font atlas) hold coverage in .r; the fragment programs expand it to white + alpha
+    mPass->getFragmentProgramParameters()->setNamedConstant("AlphaTexture", 0.f);
+    // Distance field font atlas: .r is thresholded at 0.5 with a one pixel ramp, derived from the screen space derivatives
+    // when the profile has them (ps_2_0 doesn't, it uses the constant, the ramp of one texel)
+    mPass->getFragmentProgramParameters()->setNamedConstant("DistanceField", 0.f);
+
+    mTexUnit =  mPass->createTextureUnitState();
+    mTexUnit->setTexture(mFontTex);
+    mTexUnit->setTextureFiltering(Ogre::TFO_NONE);
+}
+
+// Feeds programs compiled by a previous run to the GpuProgramManager, which then skips compiling them.
+// Only render systems which can hand out compiled shaders (D3D9/D3D11 in OGRE 1.9) make use of it.
+void OgreImGui::loadShaderCache(Ogre::uint32 sourceHash)
+{
+    Ogre::GpuProgramManager& gpuMgr = Ogre::GpuProgramManager::getSingleton();
+    if (mShaderCachePath.empty() || !gpuMgr.canGetCompiledShaderBuffer())
+    {
+        return;
+    }
+    // Needed to have the ImGui programs compiled next end up in the cache; createMaterial() restores the setting
+    gpuMgr.setSaveMicrocodesToCache(true);
+
+    Ogre::DataStreamPtr stream;
+    try
+    {
+        stream = Ogre::Root::getSingleton().openFileStream(mShaderCachePath);
+    }
+    catch (Ogre::FileNotFoundException&)
+    {
+        return; // First run
+    }
+
+    Ogre::uint32 cachedHash = 0;
+    if (stream->read(&cachedHash, sizeof(cachedHash)) == sizeof(cachedHash) && cachedHash == sourceHash)
+    {
+        gpuMgr.loadMicrocodeCache(stream);
+    }
+}
+
+// Writes the cache back if anything had to be compiled
+void OgreImGui::saveShaderCache(Ogre::uint32 sourceHash)
+{
+    Ogre::GpuProgramManager& gpuMgr = Ogre::GpuProgramManager::getSingleton();
+    if (mShaderCachePath.empty() || !gpuMgr.canGetCompiledShaderBuffer() || !gpuMgr.isCacheDirty())
+    {
+        return;
+    }
+
+    Ogre::DataStreamPtr stream = Ogre::Root::getSingleton().createFileStream(mShaderCachePath,
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    stream->write(&sourceHash, sizeof(sourceHash));
+    gpuMgr.saveMicrocodeCache(stream);
 }
 
 void OgreImGui::createFontTexture()
@@ -418,19 +804,36 @@ void OgreImGui::createFontTexture()
     io.Fonts->AddFontFromFileTTF("fonts/Roboto-Medium.ttf", 16.0f);
     unsigned char* pixels;
     int width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
-
-    mFontTex = Ogre::TextureManager::getSingleton().createManual("ImguiFontTex",Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,Ogre::TEX_TYPE_2D,width,height,1,1,Ogre::PF_R8G8B8A8);
-
-    // Lock texture for writing
-    const Ogre::PixelBox & lockBox = mFontTex->getBuffer()->lock(Ogre::Image::Box(0, 0, width, height), Ogre::HardwareBuffer::HBL_DISCARD);
+    const bool cacheLoaded = !mFontCachePath.empty() && ImguiFontCache::LoadAtlas(io.Fonts, mFontCachePath.c_str());
+    io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height); // Rasterizes and packs the glyphs unless loaded from the cache
+    if (!cacheLoaded && !mFontCachePath.empty())
+    {
+        ImguiFontCache::SaveAtlas(io.Fonts, mFontCachePath.c_str());
+    }
 
-    // Copy texture to ImGui
-    size_t texDepth = Ogre::PixelUtil::getNumElemBytes(lockBox.format);
-    memcpy(lockBox.data,pixels, width*height*texDepth);
+    // Coverage only, a quarter of the memory of RGBA; see AlphaTexture in the fragment programs
+    mFontTex = Ogre::TextureManager::getSingleton().createManual("ImguiFontTex",Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,Ogre::TEX_TYPE_2D,width,height,1,1,Ogre::PF_L8);
 
-    // Unlock
-    mFontTex->getBuffer()->unlock();
+    // Copy ImGui's atlas to the texture
+    if (IsCoverageFormat(mFontTex->getFormat()))
+    {
+        const Ogre::PixelBox srcBox(width, height, 1, Ogre::PF_L8, pixels);
+        mFontTex->getBuffer()->blitFromMemory(srcBox);
+    }
+    else
+    {
+        // The render system picked another format, e.g. A8 or A8R8G8B8. Converting luminance there would lose
+        // the coverage (A8 keeps only alpha, which luminance doesn't have), so store it in every channel of RGBA.
+        mFontTex->freeInternalResources();
+        mFontTex->setFormat(Ogre::PF_A8R8G8B8);
+        mFontTex->createInternalResources();
+        ImVector<ImU32> texels;
+        ExpandCoverage(pixels, width * height, texels);
+        const Ogre::PixelBox srcBox(width, height, 1, Ogre::PF_A8R8G8B8, texels.Data);
+        mFontTex->getBuffer()->blitFromMemory(srcBox);
+    }
+    io.Fonts->ClearTexDirtyRect(); // Uploaded whole; with dynamic glyphs, EndFrame() picks up the changes from here on
+    mFontDistanceField = io.Fonts->DistanceFieldGlyphs ? 0.5f / io.Fonts->DistanceFieldSpread : 0.f; // Texel value change per texel
 
     // Save the texture for inspection
     Ogre::Image outImage;
@@ -440,13 +843,15 @@ void OgreImGui::createFontTexture()
 
 void OgreImGui::NewFrame(float deltaTime, float displayWidth, float displayHeight)
 {
+    const double startTime = ImguiFrameTimings::getTime();
     ImGuiIO& io = ImGui::GetIO();
     io.DeltaTime = deltaTime;
+    applyInputEvents(startTime);
 
-     // Read keyboard modifiers inputs
-    io.KeyCtrl = mKeyInput->isKeyDown(OIS::KC_LCONTROL);
-    io.KeyShift = mKeyInput->isKeyDown(OIS::KC_LSHIFT);
-    io.KeyAlt = mKeyInput->isKeyDown(OIS::KC_LMENU);
+    // Keyboard modifiers from the queued key state, so they stay in step with the keys they modify
+    io.KeyCtrl = io.KeysDown[OIS::KC_LCONTROL] || io.KeysDown[OIS::KC_RCONTROL];
+    io.KeyShift = io.KeysDown[OIS::KC_LSHIFT] || io.KeysDown[OIS::KC_RSHIFT];
+    io.KeyAlt = io.KeysDown[OIS::KC_LMENU] || io.KeysDown[OIS::KC_RMENU];
     io.KeySuper = false;
 
     // Setup display size (every frame to accommodate for window resizing)
@@ -454,13 +859,18 @@ void OgreImGui::NewFrame(float deltaTime, float displayWidth, float displayHeigh
 
     // Start the frame
     ImGui::NewFrame();
+
+    mUserBuildStartTime = ImguiFrameTimings::getTime();
+    mFrameTimings.record(ImguiFrameTimings::ST_NEW_FRAME, mUserBuildStartTime - startTime);
 }
 
 // -------------------------- ImGui Renderable ------------------------------ // 
 
- OgreImGui::ImGUIRenderable::ImGUIRenderable():
-    mVertexBufferSize(5000),
-    mIndexBufferSize(10000)
+ OgreImGui::ImGUIRenderable::ImGUIRenderable(OgreImGui* owner):
+    mOwner(owner),
+    mRenderSys(0),
+    mAlphaTexture(0.f),
+    mDistanceField(0.f)
 {
     this->initImGUIRenderable();
 
@@ -530,41 +940,97 @@ const Ogre::MaterialPtr& OgreImGui::ImGUIRenderable::getMaterial(void) const
     return mMaterial;
 }
 
+// Ogre index type matching ImDrawIdx; '#define ImDrawIdx unsigned int' in imconfig.h switches the backend to 32-bit indices
+static const Ogre::HardwareIndexBuffer::IndexType ImDrawIdxType =
+    (sizeof(ImDrawIdx) == 4) ? Ogre::HardwareIndexBuffer::IT_32BIT : Ogre::HardwareIndexBuffer::IT_16BIT;
+
 /// @author https://bitbucket.org/ChaosCreator/imgui-ogre2.1-binding/src/8f1a01db510f543a987c3c16859d0a33400d9097/ImguiRenderable.cpp?at=master&fileviewer=file-view-default
 /// Commentary on OGRE forums: http://www.ogre3d.org/forums/viewtopic.php?f=5&t=89081#p531059
-void OgreImGui::ImGUIRenderable::updateVertexData(const ImDrawVert* vtxBuf, const ImDrawIdx* idxBuf, unsigned int vtxCount, unsigned int idxCount)
+void OgreImGui::ImGUIRenderable::createVertexBuffer(unsigned int numVertices)
 {
-	Ogre::VertexBufferBinding* bind = mRenderOp.vertexData->vertexBufferBinding;
+    mRenderOp.vertexData->vertexBufferBinding->setBinding(0, Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+        sizeof(ImDrawVert), numVertices, Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE));
+}
 
-	if (bind->getBindings().empty() || mVertexBufferSize != vtxCount)
-	{
-		mVertexBufferSize = vtxCount;
+void OgreImGui::ImGUIRenderable::createIndexBuffer(unsigned int numIndices)
+{
+    mRenderOp.indexData->indexBuffer = Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+        ImDrawIdxType, numIndices, Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+}
 
-		bind->setBinding(0, Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(sizeof(ImDrawVert), mVertexBufferSize, Ogre::HardwareBuffer::HBU_WRITE_ONLY));
-	}
-	if (mRenderOp.indexData->indexBuffer.isNull() || mIndexBufferSize != idxCount)
-	{
-		mIndexBufferSize = idxCount;
+void OgreImGui::ImGUIRenderable::lockBuffers(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount,
+                                             bool discard, ImDrawVert** vtxDst, ImDrawIdx** idxDst)
+{
+    const Ogre::HardwareBuffer::LockOptions lockOpt = discard ? Ogre::HardwareBuffer::HBL_DISCARD : Ogre::HardwareBuffer::HBL_NO_OVERWRITE;
+    *vtxDst = (ImDrawVert*)(mRenderOp.vertexData->vertexBufferBinding->getBuffer(0)->lock(vtxStart * sizeof(ImDrawVert), vtxCount * sizeof(ImDrawVert), lockOpt));
+    *idxDst = (ImDrawIdx*)(mRenderOp.indexData->indexBuffer->lock(idxStart * sizeof(ImDrawIdx), idxCount * sizeof(ImDrawIdx), lockOpt));
+}
 
-		mRenderOp.indexData->indexBuffer =
-			Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(Ogre::HardwareIndexBuffer::IT_16BIT, mIndexBufferSize, Ogre::HardwareBuffer::HBU_WRITE_ONLY);
-	}
+void OgreImGui::ImGUIRenderable::unlockBuffers()
+{
+    mRenderOp.vertexData->vertexBufferBinding->getBuffer(0)->unlock();
+    mRenderOp.indexData->indexBuffer->unlock();
+}
+
+void OgreImGui::ImGUIRenderable::beginRender()
+{
+    mRenderSys = Ogre::Root::getSingletonPtr()->getRenderSystem();
+    Ogre::Pass* pass = mOwner->mPass;
+    mOwner->mSceneMgr->_setPass(pass, true, false);
+    mRenderSys->bindGpuProgramParameters(Ogre::GPT_VERTEX_PROGRAM, pass->getVertexProgramParameters(), Ogre::GPV_ALL);
+    mRenderSys->bindGpuProgramParameters(Ogre::GPT_FRAGMENT_PROGRAM, pass->getFragmentProgramParameters(), Ogre::GPV_ALL);
+}
+
+void OgreImGui::ImGUIRenderable::setScissor(int left, int top, int right, int bottom)
+{
+    mRenderSys->setScissorTest(true, left, top, right, bottom);
+}
 
-	// Copy all vertices
-	ImDrawVert* vtxDst = (ImDrawVert*)(bind->getBuffer(0)->lock(Ogre::HardwareBuffer::HBL_DISCARD));
-	ImDrawIdx* idxDst = (ImDrawIdx*)(mRenderOp.indexData->indexBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD));
+void OgreImGui::ImGUIRenderable::setTexture(ImTextureID texId)
+{
+    // Filtering is re-applied because some render systems keep it per texture object
+    const Ogre::TextureUnitState* texUnit = mOwner->mTexUnit;
+    const Ogre::TexturePtr tex = mOwner->getTexture(texId);
+    const float distanceField = (tex == mOwner->mFontTex) ? mOwner->mFontDistanceField : 0.f;
+    mRenderSys->_setTexture(0, true, tex);
+    if (distanceField > 0.f)
+    {
+        // The distance field is interpolated between texels, that's what keeps scaled glyphs sharp
+        mRenderSys->_setTextureUnitFiltering(0, Ogre::FO_LINEAR, Ogre::FO_LINEAR, Ogre::FO_NONE);
+    }
+    else
+    {
+        mRenderSys->_setTextureUnitFiltering(0, texUnit->getTextureFiltering(Ogre::FT_MIN),
+            texUnit->getTextureFiltering(Ogre::FT_MAG), texUnit->getTextureFiltering(Ogre::FT_MIP));
+    }
 
-	memcpy(vtxDst, vtxBuf, mVertexBufferSize * sizeof(ImDrawVert));
-	memcpy(idxDst, idxBuf, mIndexBufferSize * sizeof(ImDrawIdx));
+    // Luminance/red-only textures are expanded to alpha by the fragment program. The font atlas holds
+    // coverage in .r whatever format it ended up with, see createFontTexture().
+    const float alphaTexture = (tex == mOwner->mFontTex || IsCoverageFormat(tex->getFormat())) ? 1.f : 0.f;
+    if (alphaTexture != mAlphaTexture || distanceField != mDistanceField)
+    {
+        mAlphaTexture = alphaTexture;
+        mDistanceField = distanceField;
+        const Ogre::GpuProgramParametersSharedPtr& params = mOwner->mPass->getFragmentProgramParameters();
+        params->setNamedConstant("AlphaTexture", alphaTexture);
+        params->setNamedConstant("DistanceField", distanceField);
+        mRenderSys->bindGpuProgramParameters(Ogre::GPT_FRAGMENT_PROGRAM, params, Ogre::GPV_ALL);
+    }
+}
 
-    mRenderOp.vertexData->vertexStart = 0;
+void OgreImGui::ImGUIRenderable::drawIndexed(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount)
+{
+    mRenderOp.vertexData->vertexStart = vtxStart;
     mRenderOp.vertexData->vertexCount = vtxCount;
-    mRenderOp.indexData->indexStart = 0;
+    mRenderOp.indexData->indexStart = idxStart;
     mRenderOp.indexData->indexCount = idxCount;
+    mRenderSys->_render(mRenderOp);
+}
 
-
-    bind->getBuffer(0)->unlock();
-    mRenderOp.indexData->indexBuffer->unlock();
+void OgreImGui::ImGUIRenderable::endRender()
+{
+    mRenderSys->setScissorTest(false);
+    mRenderSys = 0;
 }
 
 void OgreImGui::ImGUIRenderable::getWorldTransforms( Ogre::Matrix4* xform ) const
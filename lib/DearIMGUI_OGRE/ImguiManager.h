@@ -11,15 +11,28 @@
 #include "OgreRenderable.h"
 #include <OgreRenderOperation.h>
 
+#include <map>
+#include <mutex>
+
+#include "ImguiBatchRenderer.h"
+#include "ImguiFrameSnapshot.h"
+#include "ImguiFrameTimings.h"
+
 class OgreImGui : public OIS::MouseListener, public OIS::KeyListener
 {
 public:
+    typedef ImguiBatchRenderer::RenderMode  RenderMode;
+    typedef ImguiBatchRenderer::RenderStats RenderStats;
+
     OgreImGui();
+    ~OgreImGui();
 
     void Init(Ogre::SceneManager* mgr, OIS::Keyboard* keyInput, OIS::Mouse* mouseInput);
+    void Shutdown(); ///< Releases GPU resources; must be called before Ogre::Root is deleted
 
 
-
+    // Inherited from OIS::MouseListener and OIS::KeyListener: the events are queued with their arrival time
+    // and applied by NewFrame(), so they may come from any thread.
     //Inherited from OIS::MouseListener
     virtual bool mouseMoved( const OIS::MouseEvent &arg ) override;
     virtual bool mousePressed( const OIS::MouseEvent &arg, OIS::MouseButtonID id ) override;
@@ -29,18 +42,79 @@ public:
     virtual bool keyPressed( const OIS::KeyEvent &arg ) override;
     virtual bool keyReleased( const OIS::KeyEvent &arg ) override;
 
-    void render();
+    /// Starts the UI frame. Applies the input queued so far in arrival order, one change per mouse button or key:
+    /// a press and its release arriving within one frame are applied over two frames rather than cancelling out.
     void NewFrame(float deltaTime, float displayWidth, float displayHeight);
+    /// Finishes the UI frame (ImGui::Render()) and hands its draw data over to render().
+    /// May run on a different thread than render(), so that building the next frame overlaps submitting this one.
+    void EndFrame();
+    /// Submits the latest frame passed to EndFrame(); must run on the thread owning the render system.
+    void render();
+
+    /// Render on demand: the application asks needsFrame() before each UI frame and skips NewFrame()/EndFrame() while it
+    /// returns false; render() then re-presents the previous frame. Off by default (needsFrame() always returns true).
+    void setRenderOnDemand(bool enable) { mRenderOnDemand = enable; }
+    bool getRenderOnDemand() const { return mRenderOnDemand; }
+    /// True when the next UI frame may differ from the last one: input is queued, the display size changed, ImGui is
+    /// animating (e.g. a dragged or edited item) or still settling, an ImGui timer (saving the .ini) runs out,
+    /// or invalidate()/invalidateAfter() was called.
+    /// Call between UI frames, from the thread running them. When it is false and the scene is static too,
+    /// the application may skip presenting altogether.
+    bool needsFrame(float displayWidth, float displayHeight);
+    /// Requests a UI frame, e.g. after the data displayed changed. May be called from any thread.
+    void invalidate();
+    /// Requests a UI frame once `seconds` have passed, e.g. for a clock or a periodic refresh. May be called from any thread.
+    void invalidateAfter(double seconds);
+
+    const RenderStats& getRenderStats() const { return mBatchRenderer.getRenderStats(); }
+    void setRenderMode(RenderMode mode) { mBatchRenderer.setRenderMode(mode); }
+    RenderMode getRenderMode() const { return mBatchRenderer.getRenderMode(); }
+
+    /// Durations of the NewFrame, user build, Render, upload and submit stages over the last frames
+    const ImguiFrameTimings& getFrameTimings() const { return mFrameTimings; }
+    /// Draws the stage timings as a window; call between NewFrame() and EndFrame()
+    void showFrameTimings(bool* open = NULL) const { mFrameTimings.showOverlay(open); }
+
+    /// Makes an OGRE texture usable with ImGui::Image()/ImageButton(); registering twice returns the same ID.
+    /// The texture is kept alive until unregisterTexture() or Shutdown(). Both may be called from any thread, e.g. the
+    /// UI thread while render() runs; IDs still referenced by the frame being drawn then fall back to the font atlas.
+    ImTextureID registerTexture(const Ogre::TexturePtr& tex);
+    void unregisterTexture(ImTextureID texId);
+
+    /// File keeping compiled shaders between runs (default "imgui_shaders.cache"); empty disables it. Set before Init().
+    void setShaderCachePath(const Ogre::String& path) { mShaderCachePath = path; }
+    /// File keeping the built font atlas between runs (default "imgui_fonts.cache"); empty disables it. Set before Init().
+    void setFontCachePath(const Ogre::String& path) { mFontCachePath = path; }
+    /// Rasterizes glyphs the first time they are displayed rather than all glyph ranges up front (see ImFontAtlas::DynamicGlyphs);
+    /// pays off with large ranges such as CJK. Disables the font cache. Set before Init().
+    void setDynamicGlyphs(bool enable) { ImGui::GetIO().Fonts->DynamicGlyphs = enable; }
+    /// Threads rendering the glyphs when the font atlas is built (see ImFontAtlas::BuildThreadCount); 0 uses every hardware thread. Set before Init().
+    void setFontBuildThreads(int count) { ImGui::GetIO().Fonts->BuildThreadCount = count; }
+    /// Bakes the fonts as signed distance fields (see ImFontAtlas::DistanceFieldGlyphs), which stay sharp when scaled up,
+    /// e.g. by ImGui::SetWindowFontScale() or io.FontGlobalScale. Set before Init().
+    void setDistanceFieldFont(bool enable) { ImGui::GetIO().Fonts->DistanceFieldGlyphs = enable; }
 
 private:
 
-    class ImGUIRenderable : public Ogre::Renderable
+    /// Implements the render device for ImguiBatchRenderer with OGRE hardware buffers and render system calls
+    class ImGUIRenderable : public Ogre::Renderable, public ImguiRenderDevice
     {
     public:
-        ImGUIRenderable();
+        ImGUIRenderable(OgreImGui* owner);
         virtual ~ImGUIRenderable();
 
-        void updateVertexData(const ImDrawVert* vtxBuf, const ImDrawIdx* idxBuf, unsigned int vtxCount, unsigned int idxCount);
+        // Inherited from ImguiRenderDevice
+        virtual void createVertexBuffer(unsigned int numVertices) override;
+        virtual void createIndexBuffer(unsigned int numIndices) override;
+        virtual void lockBuffers(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount,
+                                 bool discard, ImDrawVert** vtxDst, ImDrawIdx** idxDst) override;
+        virtual void unlockBuffers() override;
+        virtual void beginRender() override;
+        virtual void setScissor(int left, int top, int right, int bottom) override;
+        virtual void setTexture(ImTextureID texId) override;
+        virtual void drawIndexed(unsigned int vtxStart, unsigned int vtxCount, unsigned int idxStart, unsigned int idxCount) override;
+        virtual void endRender() override;
+
         Ogre::Real getSquaredViewDepth(const Ogre::Camera* cam) const   { (void)cam; return 0; }
 
         void setMaterial( const Ogre::String& matName );
@@ -50,22 +124,79 @@ private:
         virtual void getRenderOperation( Ogre::RenderOperation& op ) override;
         virtual const Ogre::LightList& getLights(void) const override;
 
-        int                      mVertexBufferSize;
-        int                      mIndexBufferSize;
-
     private:
         void initImGUIRenderable(void);
 
-        Ogre::MaterialPtr mMaterial;
+        OgreImGui*            mOwner;
+        Ogre::RenderSystem*   mRenderSys; ///< Valid between beginRender() and endRender()
+        float                 mAlphaTexture; ///< Value of the AlphaTexture fragment program constant
+        float                 mDistanceField; ///< Value of the DistanceField fragment program constant
+        Ogre::MaterialPtr     mMaterial;
         Ogre::RenderOperation mRenderOp;
     };
 
+    typedef std::map<ImTextureID, Ogre::TexturePtr> TextureRegistry;
+
+    /// Font atlas pixels changed by dynamic glyphs, copied by EndFrame() for render() to upload
+    struct FontTexUpdate
+    {
+        FontTexUpdate();
+
+        int                     texWidth;   ///< Atlas size; the texture is resized when it differs
+        int                     texHeight;
+        int                     x0, y0;     ///< Changed rectangle, empty when x0 >= x1
+        int                     x1, y1;
+        ImVector<unsigned char> rows;       ///< Atlas rows y0 to y1, texWidth bytes each
+    };
+
+    /// Input received from OIS, waiting for NewFrame()
+    struct InputEvent
+    {
+        enum Type { MouseMove, MouseButton, Key, Character };
+
+        Type   type;
+        double time;    ///< Arrival, in seconds of a steady clock
+        int    code;    ///< Mouse button, OIS::KeyCode or character
+        bool   down;    ///< MouseButton, Key: pressed or released
+        float  x, y;    ///< MouseMove: absolute position
+    };
+
+    void queueInputEvent(InputEvent::Type type, int code, bool down, float x = 0.f, float y = 0.f);
+    void applyInputEvents(double frameTime);
+    bool isUiAnimating() const;
     void createFontTexture();
+    void queueFontTextureUpdate(ImFontAtlas* atlas);
+    void updateFontTexture();
     void createMaterial();
+    void loadShaderCache(Ogre::uint32 sourceHash);
+    void saveShaderCache(Ogre::uint32 sourceHash);
+    Ogre::TexturePtr getTexture(ImTextureID texId);
 
     Ogre::SceneManager*         mSceneMgr;
     Ogre::Pass*                 mPass;
+    Ogre::TextureUnitState*     mTexUnit;
     Ogre::TexturePtr            mFontTex;
+    float                       mFontDistanceField; ///< DistanceField constant drawing mFontTex, 0 unless it holds distance field glyphs
+    ImGUIRenderable*            mRenderable; ///< Owns the long-lived GPU buffers, reused every frame
+    ImguiBatchRenderer          mBatchRenderer;
+    ImguiFrameSnapshot          mSnapshots[2];
+    ImguiFrameSnapshot*         mFrontSnapshot; ///< Latest complete frame, drawn by render(); guarded by mSnapshotMutex
+    ImguiFrameSnapshot*         mBackSnapshot;  ///< Filled by EndFrame(), only touched by the UI thread
+    bool                        mHasFrame;      ///< EndFrame() was called at least once; guarded by mSnapshotMutex
+    FontTexUpdate               mFontTexUpdate; ///< Guarded by mSnapshotMutex
+    ImguiFrameTimings           mFrameTimings;
+    double                      mUserBuildStartTime; ///< End of NewFrame(), start of the ST_USER_BUILD stage
+    std::mutex                  mSnapshotMutex;
+    ImVector<InputEvent>        mInputQueue; ///< In arrival order; guarded by mInputMutex
+    bool                        mInvalidated;   ///< invalidate() was called; guarded by mInputMutex
+    double                      mInvalidateTime;///< Time requested by invalidateAfter(), 0 = none; guarded by mInputMutex
+    std::mutex                  mInputMutex;
+    bool                        mRenderOnDemand;
+    int                         mSettleFrames;  ///< UI frames still needed after the last change before ImGui is idle
+    Ogre::String                mShaderCachePath;
+    Ogre::String                mFontCachePath;
+    TextureRegistry             mTextures;   ///< Guarded by mTexturesMutex
+    std::mutex                  mTexturesMutex;
     OIS::Keyboard*              mKeyInput;
     OIS::Mouse*                 mMouseInput;
 };